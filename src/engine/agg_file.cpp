@@ -52,11 +52,28 @@ namespace fheroes2
             _files.clear();
             return false;
         }
-        return !_stream.fail();
+
+        if ( _stream.fail() ) {
+            return false;
+        }
+
+        // The stream is still used if the archive can not be mapped into memory
+        if ( _mappedFile.open( fileName ) && _mappedFile.size() != size ) {
+            _mappedFile.close();
+        }
+
+        return true;
     }
 
     std::vector<uint8_t> AGGFile::read( const std::string & fileName )
     {
+        if ( _mappedFile.isOpen() ) {
+            size_t size = 0;
+            const uint8_t * data = getData( fileName, size );
+
+            return data != nullptr ? std::vector<uint8_t>( data, data + size ) : std::vector<uint8_t>();
+        }
+
         auto it = _files.find( fileName );
         if ( it != _files.end() ) {
             const auto & fileParams = it->second;
@@ -68,6 +85,29 @@ namespace fheroes2
 
         return std::vector<uint8_t>();
     }
+
+    const uint8_t * AGGFile::getData( const std::string & fileName, size_t & size ) const
+    {
+        size = 0;
+
+        if ( !_mappedFile.isOpen() ) {
+            return nullptr;
+        }
+
+        const auto it = _files.find( fileName );
+        if ( it == _files.end() ) {
+            return nullptr;
+        }
+
+        const uint32_t fileSize = it->second.first;
+        const uint32_t fileOffset = it->second.second;
+        if ( fileSize == 0 || static_cast<size_t>( fileOffset ) + fileSize > _mappedFile.size() ) {
+            return nullptr;
+        }
+
+        size = fileSize;
+        return _mappedFile.data() + fileOffset;
+    }
 }
 
 StreamBase & operator>>( StreamBase & st, fheroes2::ICNHeader & icn )
@@ -21,8 +21,8 @@
 #ifndef AGG_FILE_H
 #define AGG_FILE_H
 
-#include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "serialize.h"
@@ -42,14 +42,27 @@ namespace fheroes2
             return !_stream.fail() && !_files.empty();
         }
 
+        // Returns true if the whole archive is mapped into memory. Then files are read without system calls and getData() can be used.
+        bool isMapped() const
+        {
+            return _mappedFile.isOpen();
+        }
+
         bool open( const std::string & fileName );
         std::vector<uint8_t> read( const std::string & fileName );
 
+        // Returns a pointer to the contents of the file inside the archive mapped into memory, no data is copied. The pointer stays valid
+        // while the archive is open. Returns nullptr if there is no such file or the archive is not mapped into memory.
+        const uint8_t * getData( const std::string & fileName, size_t & size ) const;
+
     private:
         static const size_t _maxFilenameSize = 15; // 8.3 ASCIIZ file name + 2-bytes padding
 
         StreamFile _stream;
-        std::map<std::string, std::pair<uint32_t, uint32_t> > _files;
+        MemoryMappedFile _mappedFile;
+
+        // File name vs its size and offset in the archive
+        std::unordered_map<std::string, std::pair<uint32_t, uint32_t>> _files;
     };
 
     struct ICNHeader
@@ -72,6 +72,7 @@ namespace Music
     bool isPlaying();
 
     std::vector<uint8_t> Xmi2Mid( const std::vector<uint8_t> & buf );
+    std::vector<uint8_t> Xmi2Mid( const uint8_t * data, const size_t size );
 }
 
 #endif
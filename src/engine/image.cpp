@@ -21,10 +21,22 @@
 #include "image.h"
 #include "image_palette.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
 
+// SSE2 is a part of every x86-64 CPU, AVX2 support is checked at runtime (currently only for GCC and Clang)
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#define FHEROES2_BLIT_SSE2
+#include <emmintrin.h>
+
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define FHEROES2_BLIT_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
 namespace
 {
     // 0 in shadow part means no shadow, 1 means skip any drawings so to don't waste extra CPU cycles for ( tableId - 2 ) command we just add extra fake tables
@@ -408,6 +420,305 @@ namespace
             }
         }
     }
+
+    // Blits a row of a two-layer image onto a single-layer image: pixels with transform value 0 are copied, pixels with transform value 1
+    // are skipped and the rest of transform values are applied to the output pixels.
+    void BlitRowToSingleLayer( const uint8_t * imageIn, const uint8_t * transformIn, uint8_t * imageOut, const int32_t width )
+    {
+        const uint8_t * imageInEnd = imageIn + width;
+
+        for ( ; imageIn != imageInEnd; ++imageIn, ++transformIn, ++imageOut ) {
+            if ( *transformIn > 0 ) { // apply a transformation
+                if ( *transformIn != 1 ) { // skip pixel
+                    *imageOut = *( transformTable + ( *transformIn ) * 256 + *imageOut );
+                }
+            }
+            else { // copy a pixel
+                *imageOut = *imageIn;
+            }
+        }
+    }
+
+    // Blits a row of a two-layer image onto another two-layer image: pixels with transform value 1 are skipped, transformations are applied
+    // only to the output pixels without transform value, the rest of pixels are copied along with their transform values.
+    void BlitRowToDoubleLayer( const uint8_t * imageIn, const uint8_t * transformIn, uint8_t * imageOut, uint8_t * transformOut, const int32_t width )
+    {
+        const uint8_t * imageInEnd = imageIn + width;
+
+        for ( ; imageIn != imageInEnd; ++imageIn, ++transformIn, ++imageOut, ++transformOut ) {
+            if ( *transformIn == 1 ) { // skip pixel
+                continue;
+            }
+
+            if ( *transformIn > 0 && *transformOut == 0 ) { // apply a transformation
+                *imageOut = *( transformTable + ( *transformIn ) * 256 + *imageOut );
+            }
+            else { // copy a pixel
+                *transformOut = *transformIn;
+                *imageOut = *imageIn;
+            }
+        }
+    }
+
+#if defined( FHEROES2_BLIT_SSE2 )
+    // Applies transformations to the pixels marked in the mask (bit N corresponds to pixel N). Transformations are table lookups, they are
+    // rare enough and can't be done by vector instructions without gathering.
+    void TransformMaskedPixels( uint32_t mask, const uint8_t * transform, uint8_t * image )
+    {
+        for ( ; mask != 0; mask >>= 1, ++transform, ++image ) {
+            if ( mask & 1 ) {
+                *image = *( transformTable + ( *transform ) * 256 + *image );
+            }
+        }
+    }
+
+    void BlitRowToSingleLayerSSE2( const uint8_t * imageIn, const uint8_t * transformIn, uint8_t * imageOut, const int32_t width )
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi8( 1 );
+
+        int32_t x = 0;
+        for ( ; x + 16 <= width; x += 16 ) {
+            const __m128i transform = _mm_loadu_si128( reinterpret_cast<const __m128i *>( transformIn + x ) );
+            const __m128i copyMask = _mm_cmpeq_epi8( transform, zero );
+
+            const uint32_t copyBits = static_cast<uint32_t>( _mm_movemask_epi8( copyMask ) );
+            const uint32_t skipBits = static_cast<uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( transform, one ) ) );
+
+            __m128i * out = reinterpret_cast<__m128i *>( imageOut + x );
+
+            if ( copyBits == 0xFFFF ) {
+                _mm_storeu_si128( out, _mm_loadu_si128( reinterpret_cast<const __m128i *>( imageIn + x ) ) );
+                continue;
+            }
+
+            if ( copyBits != 0 ) {
+                const __m128i in = _mm_loadu_si128( reinterpret_cast<const __m128i *>( imageIn + x ) );
+                _mm_storeu_si128( out, _mm_or_si128( _mm_and_si128( copyMask, in ), _mm_andnot_si128( copyMask, _mm_loadu_si128( out ) ) ) );
+            }
+
+            TransformMaskedPixels( ~( copyBits | skipBits ) & 0xFFFF, transformIn + x, imageOut + x );
+        }
+
+        BlitRowToSingleLayer( imageIn + x, transformIn + x, imageOut + x, width - x );
+    }
+
+    void BlitRowToDoubleLayerSSE2( const uint8_t * imageIn, const uint8_t * transformIn, uint8_t * imageOut, uint8_t * transformOut, const int32_t width )
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi8( 1 );
+        const __m128i allBits = _mm_set1_epi8( -1 );
+
+        int32_t x = 0;
+        for ( ; x + 16 <= width; x += 16 ) {
+            const __m128i transform = _mm_loadu_si128( reinterpret_cast<const __m128i *>( transformIn + x ) );
+            const __m128i skipMask = _mm_cmpeq_epi8( transform, one );
+
+            if ( _mm_movemask_epi8( skipMask ) == 0xFFFF ) {
+                continue;
+            }
+
+            __m128i * imageOutX = reinterpret_cast<__m128i *>( imageOut + x );
+            __m128i * transformOutX = reinterpret_cast<__m128i *>( transformOut + x );
+
+            const __m128i outTransform = _mm_loadu_si128( transformOutX );
+
+            // Transformations are applied only to the output pixels without transform value
+            const __m128i transformMask = _mm_andnot_si128( _mm_or_si128( _mm_cmpeq_epi8( transform, zero ), skipMask ), _mm_cmpeq_epi8( outTransform, zero ) );
+            const __m128i copyMask = _mm_andnot_si128( _mm_or_si128( skipMask, transformMask ), allBits );
+
+            const uint32_t copyBits = static_cast<uint32_t>( _mm_movemask_epi8( copyMask ) );
+            const __m128i in = _mm_loadu_si128( reinterpret_cast<const __m128i *>( imageIn + x ) );
+
+            if ( copyBits == 0xFFFF ) {
+                _mm_storeu_si128( imageOutX, in );
+                _mm_storeu_si128( transformOutX, transform );
+                continue;
+            }
+
+            if ( copyBits != 0 ) {
+                _mm_storeu_si128( imageOutX, _mm_or_si128( _mm_and_si128( copyMask, in ), _mm_andnot_si128( copyMask, _mm_loadu_si128( imageOutX ) ) ) );
+                _mm_storeu_si128( transformOutX, _mm_or_si128( _mm_and_si128( copyMask, transform ), _mm_andnot_si128( copyMask, outTransform ) ) );
+            }
+
+            TransformMaskedPixels( static_cast<uint32_t>( _mm_movemask_epi8( transformMask ) ), transformIn + x, imageOut + x );
+        }
+
+        BlitRowToDoubleLayer( imageIn + x, transformIn + x, imageOut + x, transformOut + x, width - x );
+    }
+#endif
+
+#if defined( FHEROES2_BLIT_AVX2 )
+    __attribute__( ( target( "avx2" ) ) ) void BlitRowToSingleLayerAVX2( const uint8_t * imageIn, const uint8_t * transformIn, uint8_t * imageOut,
+                                                                         const int32_t width )
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi8( 1 );
+
+        int32_t x = 0;
+        for ( ; x + 32 <= width; x += 32 ) {
+            const __m256i transform = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( transformIn + x ) );
+            const __m256i copyMask = _mm256_cmpeq_epi8( transform, zero );
+
+            const uint32_t copyBits = static_cast<uint32_t>( _mm256_movemask_epi8( copyMask ) );
+            const uint32_t skipBits = static_cast<uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( transform, one ) ) );
+
+            __m256i * out = reinterpret_cast<__m256i *>( imageOut + x );
+
+            if ( copyBits == 0xFFFFFFFF ) {
+                _mm256_storeu_si256( out, _mm256_loadu_si256( reinterpret_cast<const __m256i *>( imageIn + x ) ) );
+                continue;
+            }
+
+            if ( copyBits != 0 ) {
+                const __m256i in = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( imageIn + x ) );
+                _mm256_storeu_si256( out, _mm256_blendv_epi8( _mm256_loadu_si256( out ), in, copyMask ) );
+            }
+
+            TransformMaskedPixels( ~( copyBits | skipBits ), transformIn + x, imageOut + x );
+        }
+
+        BlitRowToSingleLayerSSE2( imageIn + x, transformIn + x, imageOut + x, width - x );
+    }
+
+    __attribute__( ( target( "avx2" ) ) ) void BlitRowToDoubleLayerAVX2( const uint8_t * imageIn, const uint8_t * transformIn, uint8_t * imageOut,
+                                                                         uint8_t * transformOut, const int32_t width )
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi8( 1 );
+
+        int32_t x = 0;
+        for ( ; x + 32 <= width; x += 32 ) {
+            const __m256i transform = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( transformIn + x ) );
+            const __m256i skipMask = _mm256_cmpeq_epi8( transform, one );
+
+            if ( static_cast<uint32_t>( _mm256_movemask_epi8( skipMask ) ) == 0xFFFFFFFF ) {
+                continue;
+            }
+
+            __m256i * imageOutX = reinterpret_cast<__m256i *>( imageOut + x );
+            __m256i * transformOutX = reinterpret_cast<__m256i *>( transformOut + x );
+
+            const __m256i outTransform = _mm256_loadu_si256( transformOutX );
+
+            // Transformations are applied only to the output pixels without transform value
+            const __m256i transformMask
+                = _mm256_andnot_si256( _mm256_or_si256( _mm256_cmpeq_epi8( transform, zero ), skipMask ), _mm256_cmpeq_epi8( outTransform, zero ) );
+            const __m256i keepMask = _mm256_or_si256( skipMask, transformMask );
+
+            const uint32_t keepBits = static_cast<uint32_t>( _mm256_movemask_epi8( keepMask ) );
+            const __m256i in = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( imageIn + x ) );
+
+            if ( keepBits == 0 ) {
+                _mm256_storeu_si256( imageOutX, in );
+                _mm256_storeu_si256( transformOutX, transform );
+                continue;
+            }
+
+            if ( keepBits != 0xFFFFFFFF ) {
+                _mm256_storeu_si256( imageOutX, _mm256_blendv_epi8( in, _mm256_loadu_si256( imageOutX ), keepMask ) );
+                _mm256_storeu_si256( transformOutX, _mm256_blendv_epi8( transform, outTransform, keepMask ) );
+            }
+
+            TransformMaskedPixels( static_cast<uint32_t>( _mm256_movemask_epi8( transformMask ) ), transformIn + x, imageOut + x );
+        }
+
+        BlitRowToDoubleLayerSSE2( imageIn + x, transformIn + x, imageOut + x, transformOut + x, width - x );
+    }
+#endif
+
+    // Blits only the pixels of the spans of the input image, transparent pixels are not touched at all
+    void BlitSpans( const fheroes2::Image & in, int32_t inX, int32_t inY, fheroes2::Image & out, int32_t outX, int32_t outY, int32_t width, int32_t height )
+    {
+        const fheroes2::Image::Spans * spans = in.spans();
+        assert( spans != nullptr );
+
+        const int32_t widthIn = in.width();
+        const int32_t widthOut = out.width();
+        const int32_t inXEnd = inX + width;
+
+        const uint8_t * imageInY = in.image() + inY * widthIn;
+        uint8_t * imageOutY = out.image() + outY * widthOut + outX;
+        uint8_t * transformOutY = out.singleLayer() ? nullptr : out.transform() + outY * widthOut + outX;
+
+        for ( int32_t y = inY; y < inY + height; ++y, imageInY += widthIn, imageOutY += widthOut ) {
+            const fheroes2::Image::Span * span = spans->spans.data() + spans->rowOffsets[y];
+            const fheroes2::Image::Span * spanEnd = spans->spans.data() + spans->rowOffsets[y + 1];
+
+            for ( ; span != spanEnd && span->offset < inXEnd; ++span ) {
+                const int32_t start = std::max( static_cast<int32_t>( span->offset ), inX );
+                const int32_t end = std::min( static_cast<int32_t>( span->offset + span->length ), inXEnd );
+                if ( start >= end ) {
+                    continue;
+                }
+
+                const uint8_t * imageIn = imageInY + start;
+                uint8_t * imageOut = imageOutY + ( start - inX );
+                const size_t length = static_cast<size_t>( end - start );
+
+                if ( span->transform == 0 ) { // copy pixels
+                    memcpy( imageOut, imageIn, length );
+
+                    if ( transformOutY != nullptr ) {
+                        memset( transformOutY + ( start - inX ), 0, length );
+                    }
+
+                    continue;
+                }
+
+                const uint8_t * table = transformTable + span->transform * 256;
+
+                if ( transformOutY == nullptr ) {
+                    for ( size_t i = 0; i < length; ++i ) {
+                        imageOut[i] = table[imageOut[i]];
+                    }
+                }
+                else {
+                    uint8_t * transformOut = transformOutY + ( start - inX );
+
+                    for ( size_t i = 0; i < length; ++i ) {
+                        if ( transformOut[i] == 0 ) { // apply a transformation
+                            imageOut[i] = table[imageOut[i]];
+                        }
+                        else { // copy a pixel
+                            transformOut[i] = span->transform;
+                            imageOut[i] = imageIn[i];
+                        }
+                    }
+                }
+            }
+
+            if ( transformOutY != nullptr ) {
+                transformOutY += widthOut;
+            }
+        }
+    }
+
+    struct BlitRowFunctions
+    {
+        void ( *toSingleLayer )( const uint8_t * imageIn, const uint8_t * transformIn, uint8_t * imageOut, const int32_t width );
+        void ( *toDoubleLayer )( const uint8_t * imageIn, const uint8_t * transformIn, uint8_t * imageOut, uint8_t * transformOut, const int32_t width );
+    };
+
+    // Returns the fastest implementation of row blitting supported by the CPU, the scalar one is a reference for the rest of implementations
+    const BlitRowFunctions & GetBlitRowFunctions()
+    {
+        static const BlitRowFunctions functions = []() -> BlitRowFunctions {
+#if defined( FHEROES2_BLIT_AVX2 )
+            __builtin_cpu_init();
+            if ( __builtin_cpu_supports( "avx2" ) ) {
+                return { BlitRowToSingleLayerAVX2, BlitRowToDoubleLayerAVX2 };
+            }
+#endif
+#if defined( FHEROES2_BLIT_SSE2 )
+            return { BlitRowToSingleLayerSSE2, BlitRowToDoubleLayerSSE2 };
+#else
+            return { BlitRowToSingleLayer, BlitRowToDoubleLayer };
+#endif
+        }();
+
+        return functions;
+    }
 }
 
 namespace fheroes2
@@ -443,6 +754,7 @@ namespace fheroes2
         std::swap( _singleLayer, image_._singleLayer );
         std::swap( _width, image_._width );
         std::swap( _height, image_._height );
+        std::swap( _spans, image_._spans );
     }
 
     Image & Image::operator=( const Image & image_ )
@@ -463,6 +775,7 @@ namespace fheroes2
             std::swap( _width, image_._width );
             std::swap( _height, image_._height );
             std::swap( _data, image_._data );
+            std::swap( _spans, image_._spans );
         }
 
         return *this;
@@ -470,6 +783,8 @@ namespace fheroes2
 
     uint8_t * Image::image()
     {
+        _spans.reset();
+
         return _data.get();
     }
 
@@ -481,6 +796,7 @@ namespace fheroes2
     void Image::clear()
     {
         _data.reset();
+        _spans.reset();
 
         _width = 0;
         _height = 0;
@@ -510,6 +826,7 @@ namespace fheroes2
         const size_t size = static_cast<size_t>( width_ * height_ );
 
         _data.reset( new uint8_t[size * 2] );
+        _spans.reset();
 
         _width = width_;
         _height = height_;
@@ -545,6 +862,46 @@ namespace fheroes2
         }
 
         memcpy( _data.get(), image._data.get(), size * 2 );
+
+        _spans = image._spans;
+    }
+
+    void Image::updateSpans()
+    {
+        _spans.reset();
+
+        if ( empty() || _singleLayer || _width > UINT16_MAX ) {
+            return;
+        }
+
+        std::shared_ptr<Spans> spans = std::make_shared<Spans>();
+        spans->rowOffsets.reserve( static_cast<size_t>( _height ) + 1 );
+
+        const uint8_t * transformY = _data.get() + _width * _height;
+
+        for ( int32_t y = 0; y < _height; ++y, transformY += _width ) {
+            spans->rowOffsets.push_back( static_cast<uint32_t>( spans->spans.size() ) );
+
+            int32_t x = 0;
+            while ( x < _width ) {
+                const uint8_t value = transformY[x];
+
+                int32_t runEnd = x + 1;
+                while ( runEnd < _width && transformY[runEnd] == value ) {
+                    ++runEnd;
+                }
+
+                if ( value != 1 ) {
+                    spans->spans.push_back( { static_cast<uint16_t>( x ), static_cast<uint16_t>( runEnd - x ), value } );
+                }
+
+                x = runEnd;
+            }
+        }
+
+        spans->rowOffsets.push_back( static_cast<uint32_t>( spans->spans.size() ) );
+
+        _spans = std::move( spans );
     }
 
     Sprite::Sprite()
@@ -1044,49 +1401,24 @@ namespace fheroes2
             uint8_t * imageOutY = out.image() + offsetOutY;
             const uint8_t * imageInYEnd = imageInY + height * widthIn;
 
+            if ( in.spans() != nullptr ) {
+                BlitSpans( in, inX, inY, out, outX, outY, width, height );
+                return;
+            }
+
+            const BlitRowFunctions & blitRow = GetBlitRowFunctions();
+
             if ( out.singleLayer() ) {
                 assert( !in.singleLayer() );
                 for ( ; imageInY != imageInYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut ) {
-                    const uint8_t * imageInX = imageInY;
-                    const uint8_t * transformInX = transformInY;
-                    uint8_t * imageOutX = imageOutY;
-                    const uint8_t * imageInXEnd = imageInX + width;
-
-                    for ( ; imageInX != imageInXEnd; ++imageInX, ++transformInX, ++imageOutX ) {
-                        if ( *transformInX > 0 ) { // apply a transformation
-                            if ( *transformInX != 1 ) { // skip pixel
-                                *imageOutX = *( transformTable + ( *transformInX ) * 256 + *imageOutX );
-                            }
-                        }
-                        else { // copy a pixel
-                            *imageOutX = *imageInX;
-                        }
-                    }
+                    blitRow.toSingleLayer( imageInY, transformInY, imageOutY, width );
                 }
             }
             else {
                 uint8_t * transformOutY = out.transform() + offsetOutY;
 
                 for ( ; imageInY != imageInYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut, transformOutY += widthOut ) {
-                    const uint8_t * imageInX = imageInY;
-                    const uint8_t * transformInX = transformInY;
-                    uint8_t * imageOutX = imageOutY;
-                    uint8_t * transformOutX = transformOutY;
-                    const uint8_t * imageInXEnd = imageInX + width;
-
-                    for ( ; imageInX != imageInXEnd; ++imageInX, ++transformInX, ++imageOutX, ++transformOutX ) {
-                        if ( *transformInX == 1 ) { // skip pixel
-                            continue;
-                        }
-
-                        if ( *transformInX > 0 && *transformOutX == 0 ) { // apply a transformation
-                            *imageOutX = *( transformTable + ( *transformInX ) * 256 + *imageOutX );
-                        }
-                        else { // copy a pixel
-                            *transformOutX = *transformInX;
-                            *imageOutX = *imageInX;
-                        }
-                    }
+                    blitRow.toDoubleLayer( imageInY, transformInY, imageOutY, transformOutY, width );
                 }
             }
         }
@@ -33,6 +33,22 @@ namespace fheroes2
     class Image
     {
     public:
+        // Run of pixels in a row which are processed in the same way: transform value 0 means copying of pixels, the rest of values
+        // are transformations. Skipped pixels (transform value 1) are not stored at all.
+        struct Span
+        {
+            uint16_t offset;
+            uint16_t length;
+            uint8_t transform;
+        };
+
+        // Spans of row N are stored in [rowOffsets[N], rowOffsets[N + 1]) range
+        struct Spans
+        {
+            std::vector<uint32_t> rowOffsets;
+            std::vector<Span> spans;
+        };
+
         Image();
         Image( int32_t width_, int32_t height_ );
         Image( const Image & image_ );
@@ -61,6 +77,8 @@ namespace fheroes2
 
         uint8_t * transform()
         {
+            _spans.reset();
+
             return _data.get() + width() * height();
         }
 
@@ -79,6 +97,16 @@ namespace fheroes2
 
         void fill( uint8_t value ); // fill 'image' layer with given value, setting 'transform' layer set to 0
 
+        // Builds spans of the transform layer so Blit can skip transparent pixels without checking them. Spans are dropped on any non-const
+        // access to the image data, so they are useful only for images which are not modified after being prepared, like sprites.
+        void updateSpans();
+
+        // Returns nullptr if there are no up to date spans
+        const Spans * spans() const
+        {
+            return _spans.get();
+        }
+
         // This is an optional indicator for image processing functions.
         // The whole image still consists of 2 layers but transform layer might be ignored in computations.
         bool singleLayer() const
@@ -99,6 +127,7 @@ namespace fheroes2
         int32_t _width;
         int32_t _height;
         std::unique_ptr<uint8_t[]> _data; // holds 2 image layers
+        std::shared_ptr<const Spans> _spans; // spans are immutable, so they are shared between copies of the image
 
         bool _singleLayer; // only for images which are not used for any other operations except displaying on screen. Non-copyable member.
     };
@@ -141,8 +141,15 @@ void Rand::DeterministicRandomGenerator::UpdateSeed( const uint32_t seed )
     _currentSeed = seed;
 }
 
-uint32_t Rand::DeterministicRandomGenerator::Get( const uint32_t from, const uint32_t to /*= 0*/ ) const
+uint32_t Rand::DeterministicRandomGenerator::Get( uint32_t from, uint32_t to /*= 0*/ ) const
 {
+    if ( from > to )
+        std::swap( from, to );
+
     ++_currentSeed;
-    return Rand::GetWithSeed( from, to, _currentSeed );
+
+    CounterBasedGenerator seededGen( _currentSeed );
+    std::uniform_int_distribution<uint32_t> distrib( from, to );
+
+    return distrib( seededGen );
 }
@@ -27,6 +27,7 @@
 #include <cassert>
 #include <cstdlib>
 #include <functional>
+#include <limits>
 #include <list>
 #include <random>
 #include <utility>
@@ -113,7 +114,43 @@ namespace Rand
         int32_t Get( const std::function<uint32_t( uint32_t )> & randomFunc );
     };
 
-    // Specific random generator that keeps and update its state
+    // Small counter-based pseudo random number generator: the state is a Weyl sequence started from the seed, every output is a
+    // mix of the current state. Unlike std::mt19937 it is cheap to create, so a new instance can be created for every random value.
+    class CounterBasedGenerator
+    {
+    public:
+        using result_type = uint32_t;
+
+        explicit CounterBasedGenerator( const uint32_t seed )
+            : _state( seed )
+        {}
+
+        static constexpr result_type min()
+        {
+            return std::numeric_limits<result_type>::min();
+        }
+
+        static constexpr result_type max()
+        {
+            return std::numeric_limits<result_type>::max();
+        }
+
+        result_type operator()()
+        {
+            _state += 0x9E3779B9;
+
+            uint32_t value = _state;
+            value = ( value ^ ( value >> 16 ) ) * 0x85EBCA6B;
+            value = ( value ^ ( value >> 13 ) ) * 0xC2B2AE35;
+            return value ^ ( value >> 16 );
+        }
+
+    private:
+        uint32_t _state;
+    };
+
+    // Specific random generator that keeps and update its state. The state is just a counter which is incremented on every call,
+    // so the sequence of values is fully defined by the seed.
     class DeterministicRandomGenerator
     {
     public:
@@ -131,16 +168,21 @@ namespace Rand
         template <typename T>
         const T & Get( const std::vector<T> & vec ) const
         {
+            assert( !vec.empty() );
+
             ++_currentSeed;
-            std::mt19937 seededGen( _currentSeed );
-            return Rand::GetWithGen( vec, seededGen );
+            CounterBasedGenerator seededGen( _currentSeed );
+            std::uniform_int_distribution<uint32_t> distrib( 0, static_cast<uint32_t>( vec.size() - 1 ) );
+
+            return vec[distrib( seededGen )];
         }
 
         template <class T>
         void Shuffle( std::vector<T> & vector ) const
         {
             ++_currentSeed;
-            Rand::ShuffleWithSeed( vector, _currentSeed );
+            CounterBasedGenerator seededGen( _currentSeed );
+            std::shuffle( vector.begin(), vector.end(), seededGen );
         }
 
     private:
@@ -29,6 +29,17 @@
 #include "logging.h"
 #include "serialize.h"
 
+#if defined( __MINGW32__ ) || defined( _MSC_VER )
+#include <windows.h>
+#define MEMORY_MAPPING_SUPPORTED
+#elif ( defined( __unix__ ) || defined( __APPLE__ ) ) && !defined( TARGET_PS_VITA ) && !defined( TARGET_NINTENDO_SWITCH )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MEMORY_MAPPING_SUPPORTED
+#endif
+
 namespace
 {
     const size_t minBufferCapacity = 1024;
@@ -641,3 +652,85 @@ std::string StreamFile::toString( size_t sz )
     std::vector<uint8_t>::const_iterator itend = std::find( buf.begin(), buf.end(), 0 );
     return std::string( buf.begin(), itend != buf.end() ? itend : buf.end() );
 }
+
+namespace fheroes2
+{
+    bool MemoryMappedFile::open( const std::string & fileName )
+    {
+        close();
+
+#if defined( MEMORY_MAPPING_SUPPORTED ) && ( defined( __MINGW32__ ) || defined( _MSC_VER ) )
+        const HANDLE file = CreateFileA( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+        if ( file == INVALID_HANDLE_VALUE ) {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if ( !GetFileSizeEx( file, &fileSize ) || fileSize.QuadPart <= 0 ) {
+            CloseHandle( file );
+            return false;
+        }
+
+        // The view of the file keeps the mapping and the file open, so their handles are not needed anymore
+        const HANDLE mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+        CloseHandle( file );
+        if ( mapping == nullptr ) {
+            return false;
+        }
+
+        const void * data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+        CloseHandle( mapping );
+        if ( data == nullptr ) {
+            return false;
+        }
+
+        _data = static_cast<const uint8_t *>( data );
+        _size = static_cast<size_t>( fileSize.QuadPart );
+
+        return true;
+#elif defined( MEMORY_MAPPING_SUPPORTED )
+        const int file = ::open( fileName.c_str(), O_RDONLY );
+        if ( file < 0 ) {
+            return false;
+        }
+
+        struct stat fileInfo;
+        if ( fstat( file, &fileInfo ) != 0 || fileInfo.st_size <= 0 ) {
+            ::close( file );
+            return false;
+        }
+
+        // The mapping stays valid after closing the file
+        void * data = mmap( nullptr, static_cast<size_t>( fileInfo.st_size ), PROT_READ, MAP_PRIVATE, file, 0 );
+        ::close( file );
+        if ( data == MAP_FAILED ) {
+            return false;
+        }
+
+        _data = static_cast<const uint8_t *>( data );
+        _size = static_cast<size_t>( fileInfo.st_size );
+
+        return true;
+#else
+        (void)fileName;
+
+        return false;
+#endif
+    }
+
+    void MemoryMappedFile::close()
+    {
+        if ( _data == nullptr ) {
+            return;
+        }
+
+#if defined( MEMORY_MAPPING_SUPPORTED ) && ( defined( __MINGW32__ ) || defined( _MSC_VER ) )
+        UnmapViewOfFile( _data );
+#elif defined( MEMORY_MAPPING_SUPPORTED )
+        munmap( const_cast<uint8_t *>( _data ), _size );
+#endif
+
+        _data = nullptr;
+        _size = 0;
+    }
+}
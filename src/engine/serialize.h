@@ -346,6 +346,44 @@ private:
 
 namespace fheroes2
 {
+    // Read-only view of the whole file mapped into memory. Memory mapping is not supported on all platforms, so the caller
+    // must be ready to read the file in the usual way if opening fails.
+    class MemoryMappedFile
+    {
+    public:
+        MemoryMappedFile() = default;
+        MemoryMappedFile( const MemoryMappedFile & ) = delete;
+
+        ~MemoryMappedFile()
+        {
+            close();
+        }
+
+        MemoryMappedFile & operator=( const MemoryMappedFile & ) = delete;
+
+        bool open( const std::string & fileName );
+        void close();
+
+        bool isOpen() const
+        {
+            return _data != nullptr;
+        }
+
+        const uint8_t * data() const
+        {
+            return _data;
+        }
+
+        size_t size() const
+        {
+            return _size;
+        }
+
+    private:
+        const uint8_t * _data = nullptr;
+        size_t _size = 0;
+    };
+
     // Get a value of type T in the system byte order from the buffer in which it was originally stored in the little-endian byte order
     template <typename T, typename = typename std::enable_if<std::is_integral<T>::value || std::is_floating_point<T>::value>::type>
     T getLEValue( const char * data, const size_t base, const size_t offset = 0 )
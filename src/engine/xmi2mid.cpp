@@ -175,9 +175,9 @@ struct XMIData
 {
     XMITracks tracks;
 
-    explicit XMIData( const std::vector<u8> & buf )
+    XMIData( const uint8_t * data, const size_t size )
     {
-        StreamBuf sb( buf );
+        StreamBuf sb( data, size );
 
         GroupChunkHeader group;
         IFFChunkHeader iff;
@@ -519,7 +519,12 @@ StreamBuf & operator<<( StreamBuf & sb, const MidData & st )
 
 std::vector<uint8_t> Music::Xmi2Mid( const std::vector<uint8_t> & buf )
 {
-    XMIData xmi( buf );
+    return Xmi2Mid( buf.data(), buf.size() );
+}
+
+std::vector<uint8_t> Music::Xmi2Mid( const uint8_t * data, const size_t size )
+{
+    XMIData xmi( data, size );
     StreamBuf sb( 16 * 4096 );
 
     if ( xmi.isvalid() ) {
@@ -25,12 +25,14 @@
 #include <cassert>
 #include <condition_variable>
 #include <map>
+#include <mutex>
 #include <queue>
 #include <thread>
 #include <utility>
 
 #include "agg.h"
 #include "agg_file.h"
+#include "agg_image.h"
 #include "audio.h"
 #include "dir.h"
 #include "embedded_image.h"
@@ -129,6 +131,28 @@ namespace AGG
     fheroes2::AGGFile heroes2_agg;
     fheroes2::AGGFile heroes2x_agg;
 
+    // Images are decoded by several threads while every AGG file which is not mapped into memory has only one reading position
+    std::mutex g_aggReadMutex;
+
+    // Returns false if the chunk can not be accessed without copying. The chunk from the expansion archive takes priority.
+    // Archives mapped into memory are only read, so they are accessed without locking.
+    bool getMappedChunk( const fheroes2::AGGFile & original, const fheroes2::AGGFile * expansion, const std::string & key, const uint8_t *& data, size_t & size )
+    {
+        if ( !original.isMapped() || ( expansion != nullptr && expansion->isGood() && !expansion->isMapped() ) ) {
+            return false;
+        }
+
+        if ( expansion != nullptr && expansion->isGood() ) {
+            data = expansion->getData( key, size );
+            if ( data != nullptr ) {
+                return true;
+            }
+        }
+
+        data = original.getData( key, size );
+        return true;
+    }
+
     std::map<int, std::vector<u8>> wav_cache;
     std::map<int, std::vector<u8>> mid_cache;
     std::vector<loop_sound_t> loop_sounds;
@@ -140,6 +164,7 @@ namespace AGG
     void LoadMID( int xmi, std::vector<u8> & );
 
     std::vector<uint8_t> ReadMusicChunk( const std::string & key, const bool ignoreExpansion = false );
+    ChunkData GetMusicChunk( const std::string & key, const bool ignoreExpansion = false );
 
     void PlayMusicInternally( const int mus, const MusicSource musicType, const bool loop );
     void PlaySoundInternally( const int m82, const int soundVolume );
@@ -362,6 +387,8 @@ namespace AGG
 
 std::vector<uint8_t> AGG::ReadChunk( const std::string & key )
 {
+    std::lock_guard<std::mutex> mutexLock( g_aggReadMutex );
+
     if ( heroes2x_agg.isGood() ) {
         // Make sure that the below container is not const and not a reference
         // so returning it from the function will invoke a move constructor instead of copy constructor.
@@ -373,6 +400,17 @@ std::vector<uint8_t> AGG::ReadChunk( const std::string & key )
     return heroes2_agg.read( key );
 }
 
+AGG::ChunkData AGG::GetChunk( const std::string & key )
+{
+    const uint8_t * data = nullptr;
+    size_t size = 0;
+    if ( getMappedChunk( heroes2_agg, &heroes2x_agg, key, data, size ) ) {
+        return ChunkData( data, size );
+    }
+
+    return ChunkData( ReadChunk( key ) );
+}
+
 std::vector<uint8_t> AGG::ReadMusicChunk( const std::string & key, const bool ignoreExpansion )
 {
     if ( !ignoreExpansion && g_midiHeroes2xAGG.isGood() ) {
@@ -386,10 +424,21 @@ std::vector<uint8_t> AGG::ReadMusicChunk( const std::string & key, const bool ig
     return g_midiHeroes2AGG.read( key );
 }
 
+AGG::ChunkData AGG::GetMusicChunk( const std::string & key, const bool ignoreExpansion )
+{
+    const uint8_t * data = nullptr;
+    size_t size = 0;
+    if ( getMappedChunk( g_midiHeroes2AGG, ignoreExpansion ? nullptr : &g_midiHeroes2xAGG, key, data, size ) ) {
+        return ChunkData( data, size );
+    }
+
+    return ChunkData( ReadMusicChunk( key, ignoreExpansion ) );
+}
+
 void AGG::LoadWAV( int m82, std::vector<u8> & v )
 {
     DEBUG_LOG( DBG_ENGINE, DBG_TRACE, M82::GetString( m82 ) );
-    const std::vector<u8> & body = ReadMusicChunk( M82::GetString( m82 ) );
+    const ChunkData body = GetMusicChunk( M82::GetString( m82 ) );
 
     if ( !body.empty() ) {
         // create WAV format
@@ -410,17 +459,17 @@ void AGG::LoadWAV( int m82, std::vector<u8> & v )
 
         v.reserve( body.size() + 44 );
         v.assign( wavHeader.data(), wavHeader.data() + 44 );
-        v.insert( v.begin() + 44, body.begin(), body.end() );
+        v.insert( v.begin() + 44, body.data(), body.data() + body.size() );
     }
 }
 
 void AGG::LoadMID( int xmi, std::vector<u8> & v )
 {
     DEBUG_LOG( DBG_ENGINE, DBG_TRACE, XMI::GetString( xmi ) );
-    const std::vector<uint8_t> & body = ReadMusicChunk( XMI::GetString( xmi ), xmi >= XMI::MIDI_ORIGINAL_KNIGHT );
+    const ChunkData body = GetMusicChunk( XMI::GetString( xmi ), xmi >= XMI::MIDI_ORIGINAL_KNIGHT );
 
     if ( !body.empty() ) {
-        v = Music::Xmi2Mid( body );
+        v = Music::Xmi2Mid( body.data(), body.size() );
     }
 }
 
@@ -650,6 +699,9 @@ AGG::AGGInitializer::AGGInitializer()
 
 AGG::AGGInitializer::~AGGInitializer()
 {
+    // Image decoding threads read the AGG files, so they have to be stopped before the files are released
+    fheroes2::AGG::stopICNDecoding();
+
     wav_cache.clear();
     mid_cache.clear();
     loop_sounds.clear();
@@ -26,6 +26,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace AGG
@@ -48,7 +49,53 @@ namespace AGG
     void PlayMusic( int mus, bool loop = true, bool asyncronizedCall = false );
     void ResetAudio();
 
+    // Contents of a chunk of the game data. It points directly to the data file mapped into memory or holds a copy of the chunk
+    // if the file is not mapped. The data stays valid while this object exists and the data files are open.
+    class ChunkData
+    {
+    public:
+        ChunkData( const uint8_t * data, const size_t size )
+            : _data( data )
+            , _size( size )
+        {}
+
+        explicit ChunkData( std::vector<uint8_t> && buffer )
+            : _buffer( std::move( buffer ) )
+            , _data( _buffer.data() )
+            , _size( _buffer.size() )
+        {}
+
+        ChunkData( const ChunkData & ) = delete;
+        ChunkData( ChunkData && ) = default;
+
+        ChunkData & operator=( const ChunkData & ) = delete;
+        ChunkData & operator=( ChunkData && ) = default;
+
+        const uint8_t * data() const
+        {
+            return _data;
+        }
+
+        size_t size() const
+        {
+            return _size;
+        }
+
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+    private:
+        std::vector<uint8_t> _buffer;
+        const uint8_t * _data;
+        size_t _size;
+    };
+
     std::vector<uint8_t> ReadChunk( const std::string & key );
+
+    // Unlike ReadChunk() this function doesn't copy the chunk if the data files are mapped into memory
+    ChunkData GetChunk( const std::string & key );
 }
 
 #endif
@@ -18,10 +18,17 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "agg.h"
@@ -31,10 +38,12 @@
 #include "icn.h"
 #include "image.h"
 #include "image_tool.h"
+#include "logging.h"
 #include "pal.h"
 #include "screen.h"
 #include "text.h"
 #include "til.h"
+#include "timing.h"
 #include "tools.h"
 #include "ui_language.h"
 #include "ui_text.h"
@@ -51,6 +60,39 @@ namespace
 
     std::map<int, std::vector<fheroes2::Sprite>> _icnVsScaledSprite;
 
+    // Memory usage of the loaded images of a single ICN or TIL
+    struct ResourceUsage
+    {
+        size_t size = 0;
+        uint64_t lastAccess = 0;
+        uint32_t pinCount = 0;
+    };
+
+    std::vector<ResourceUsage> _icnUsage( ICN::LASTICN );
+    std::vector<ResourceUsage> _tilUsage( TIL::LASTTIL );
+
+    struct CacheStatistics
+    {
+        size_t residentSize = 0;
+        uint64_t accessCount = 0;
+        uint64_t hitCount = 0;
+        uint64_t missCount = 0;
+        uint64_t evictionCount = 0;
+        double decodeTime = 0; // in seconds
+    };
+
+    CacheStatistics _cacheStatistics;
+
+#if defined( TARGET_PS_VITA ) || defined( TARGET_NINTENDO_SWITCH )
+    // Handheld devices have little memory so only images of the recently visited screens are kept
+    size_t _cacheMemoryLimit = 64 * 1024 * 1024;
+#else
+    size_t _cacheMemoryLimit = 0;
+#endif
+
+    // Depth of nested image loading, modified ICNs are often made of other ICNs
+    int _loadingDepth = 0;
+
     bool IsValidICNId( int id )
     {
         return id >= 0 && static_cast<size_t>( id ) < _icnVsSprite.size();
@@ -61,6 +103,258 @@ namespace
         return id >= 0 && static_cast<size_t>( id ) < _tilVsImage.size();
     }
 
+    size_t getImageMemorySize( const fheroes2::Image & image )
+    {
+        // Both image and transform layers are always allocated
+        size_t size = static_cast<size_t>( image.width() ) * static_cast<size_t>( image.height() ) * 2;
+
+        const fheroes2::Image::Spans * spans = image.spans();
+        if ( spans != nullptr ) {
+            size += spans->rowOffsets.size() * sizeof( uint32_t ) + spans->spans.size() * sizeof( fheroes2::Image::Span );
+        }
+
+        return size;
+    }
+
+    template <typename T>
+    size_t getImagesMemorySize( const std::vector<T> & images )
+    {
+        size_t size = 0;
+        for ( const T & image : images ) {
+            size += getImageMemorySize( image );
+        }
+
+        return size;
+    }
+
+    // Alphabets of these fonts are generated for the chosen language so they can not be loaded again from the resources
+    bool isEvictableICN( const int icnId )
+    {
+        return icnId != ICN::FONT && icnId != ICN::SMALFONT;
+    }
+
+    void updateResourceSize( ResourceUsage & usage, const size_t size )
+    {
+        _cacheStatistics.residentSize = _cacheStatistics.residentSize - usage.size + size;
+        usage.size = size;
+    }
+
+    void touchResource( ResourceUsage & usage )
+    {
+        usage.lastAccess = ++_cacheStatistics.accessCount;
+    }
+
+    std::vector<fheroes2::Sprite> decodeICN( const AGG::ChunkData & body )
+    {
+        std::vector<fheroes2::Sprite> sprites;
+
+        if ( body.empty() ) {
+            return sprites;
+        }
+
+        StreamBuf imageStream( body.data(), body.size() );
+
+        const uint32_t count = imageStream.getLE16();
+        const uint32_t blockSize = imageStream.getLE32();
+        if ( count == 0 || blockSize == 0 ) {
+            return sprites;
+        }
+
+        sprites.resize( count );
+
+        for ( uint32_t i = 0; i < count; ++i ) {
+            imageStream.seek( headerSize + i * 13 );
+
+            fheroes2::ICNHeader header1;
+            imageStream >> header1;
+
+            uint32_t sizeData = 0;
+            if ( i + 1 != count ) {
+                fheroes2::ICNHeader header2;
+                imageStream >> header2;
+                sizeData = header2.offsetData - header1.offsetData;
+            }
+            else {
+                sizeData = blockSize - header1.offsetData;
+            }
+
+            const uint8_t * data = body.data() + headerSize + header1.offsetData;
+
+            sprites[i] = fheroes2::decodeICNSprite( data, sizeData, header1.width, header1.height, static_cast<int16_t>( header1.offsetX ),
+                                                    static_cast<int16_t>( header1.offsetY ) );
+        }
+
+        return sprites;
+    }
+
+    // Decodes original ICN files in worker threads. Workers do not touch the image cache: decoded sprites are kept aside
+    // until the main thread requests them, so the cache is accessed by the main thread only.
+    class AsyncICNDecoder
+    {
+    public:
+        AsyncICNDecoder() = default;
+        AsyncICNDecoder( const AsyncICNDecoder & ) = delete;
+
+        ~AsyncICNDecoder()
+        {
+            stop();
+        }
+
+        AsyncICNDecoder & operator=( const AsyncICNDecoder & ) = delete;
+
+        // Waits for the workers to finish the current tasks and stops them. Queued tasks are dropped and nothing is decoded afterwards.
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> mutexLock( _mutex );
+
+                _exitFlag = true;
+                _workerNotification.notify_all();
+            }
+
+            for ( std::thread & worker : _workers ) {
+                worker.join();
+            }
+
+            _workers.clear();
+            _tasks.clear();
+            _results.clear();
+        }
+
+        void push( const int icnId )
+        {
+            std::lock_guard<std::mutex> mutexLock( _mutex );
+
+            if ( _exitFlag ) {
+                return;
+            }
+
+            if ( _results.find( icnId ) != _results.end() ) {
+                // This ICN is already queued or decoded
+                return;
+            }
+
+            _createThreadsIfNeeded();
+
+            _results.emplace( icnId, Result() );
+            _tasks.push_back( icnId );
+            _workerNotification.notify_one();
+        }
+
+        // Moves decoded sprites of the ICN into the given container. Waits for the decoding if it is in progress.
+        // Returns false if the ICN has not been requested for decoding or the decoding has not been started yet.
+        bool take( const int icnId, std::vector<fheroes2::Sprite> & sprites )
+        {
+            std::unique_lock<std::mutex> mutexLock( _mutex );
+
+            auto resultIter = _results.find( icnId );
+            if ( resultIter == _results.end() ) {
+                return false;
+            }
+
+            const auto taskIter = std::find( _tasks.begin(), _tasks.end(), icnId );
+            if ( taskIter != _tasks.end() ) {
+                // It is faster to decode it right now than to wait for other tasks
+                _tasks.erase( taskIter );
+                _results.erase( resultIter );
+                return false;
+            }
+
+            _masterNotification.wait( mutexLock, [this, icnId] { return _results[icnId].isReady; } );
+
+            // The iterator could be invalidated while waiting
+            resultIter = _results.find( icnId );
+            sprites = std::move( resultIter->second.sprites );
+            _results.erase( resultIter );
+
+            return true;
+        }
+
+        // Frees the sprites which have been decoded, but never requested
+        void clearUnused()
+        {
+            std::lock_guard<std::mutex> mutexLock( _mutex );
+
+            for ( auto iter = _results.begin(); iter != _results.end(); ) {
+                if ( iter->second.isReady ) {
+                    iter = _results.erase( iter );
+                }
+                else {
+                    ++iter;
+                }
+            }
+        }
+
+    private:
+        struct Result
+        {
+            std::vector<fheroes2::Sprite> sprites;
+            bool isReady = false;
+        };
+
+        std::vector<std::thread> _workers;
+        std::mutex _mutex;
+
+        std::condition_variable _workerNotification;
+        std::condition_variable _masterNotification;
+
+        std::deque<int> _tasks;
+        std::map<int, Result> _results;
+
+        bool _exitFlag = false;
+
+        void _createThreadsIfNeeded()
+        {
+            if ( !_workers.empty() ) {
+                return;
+            }
+
+            // Leave one core for the main thread
+            const uint32_t coreCount = std::thread::hardware_concurrency();
+            const uint32_t workerCount = coreCount > 2 ? std::min( coreCount - 1, 4u ) : 1;
+
+            for ( uint32_t i = 0; i < workerCount; ++i ) {
+                _workers.emplace_back( AsyncICNDecoder::_workerThread, this );
+            }
+        }
+
+        static void _workerThread( AsyncICNDecoder * decoder )
+        {
+            assert( decoder != nullptr );
+
+            while ( true ) {
+                std::unique_lock<std::mutex> mutexLock( decoder->_mutex );
+                decoder->_workerNotification.wait( mutexLock, [decoder] { return decoder->_exitFlag || !decoder->_tasks.empty(); } );
+
+                if ( decoder->_exitFlag ) {
+                    break;
+                }
+
+                const int icnId = decoder->_tasks.front();
+                decoder->_tasks.pop_front();
+
+                mutexLock.unlock();
+
+                std::vector<fheroes2::Sprite> sprites = decodeICN( ::AGG::GetChunk( ICN::GetString( icnId ) ) );
+
+                // Spans are built here as well to save the time of the main thread, original sprites are rarely modified
+                for ( fheroes2::Sprite & sprite : sprites ) {
+                    sprite.updateSpans();
+                }
+
+                mutexLock.lock();
+
+                Result & result = decoder->_results[icnId];
+                result.sprites = std::move( sprites );
+                result.isReady = true;
+
+                decoder->_masterNotification.notify_all();
+            }
+        }
+    };
+
+    AsyncICNDecoder _asyncICNDecoder;
+
     fheroes2::Image createDigit( const int32_t width, const int32_t height, const std::vector<fheroes2::Point> & points )
     {
         fheroes2::Image digit( width, height );
@@ -1901,43 +2195,11 @@ namespace fheroes2
     {
         void LoadOriginalICN( int id )
         {
-            const std::vector<uint8_t> & body = ::AGG::ReadChunk( ICN::GetString( id ) );
-
-            if ( body.empty() ) {
+            if ( _asyncICNDecoder.take( id, _icnVsSprite[id] ) ) {
                 return;
             }
 
-            StreamBuf imageStream( body );
-
-            const uint32_t count = imageStream.getLE16();
-            const uint32_t blockSize = imageStream.getLE32();
-            if ( count == 0 || blockSize == 0 ) {
-                return;
-            }
-
-            _icnVsSprite[id].resize( count );
-
-            for ( uint32_t i = 0; i < count; ++i ) {
-                imageStream.seek( headerSize + i * 13 );
-
-                ICNHeader header1;
-                imageStream >> header1;
-
-                uint32_t sizeData = 0;
-                if ( i + 1 != count ) {
-                    ICNHeader header2;
-                    imageStream >> header2;
-                    sizeData = header2.offsetData - header1.offsetData;
-                }
-                else {
-                    sizeData = blockSize - header1.offsetData;
-                }
-
-                const uint8_t * data = body.data() + headerSize + header1.offsetData;
-
-                _icnVsSprite[id][i]
-                    = decodeICNSprite( data, sizeData, header1.width, header1.height, static_cast<int16_t>( header1.offsetX ), static_cast<int16_t>( header1.offsetY ) );
-            }
+            _icnVsSprite[id] = decodeICN( ::AGG::GetChunk( ICN::GetString( id ) ) );
         }
 
         // Helper function for LoadModifiedICN
@@ -2046,7 +2308,7 @@ namespace fheroes2
 
                 if ( id == ICN::SMALFONT ) {
                     // Small font in official Polish GoG version has all letters to be shifted by 1 pixel lower.
-                    const std::vector<uint8_t> & body = ::AGG::ReadChunk( ICN::GetString( id ) );
+                    const ::AGG::ChunkData body = ::AGG::GetChunk( ICN::GetString( id ) );
                     const uint32_t crc32 = fheroes2::calculateCRC32( body.data(), body.size() );
                     if ( crc32 == 0xE9EC7A63 ) {
                         for ( Sprite & letter : imageArray ) {
@@ -3191,26 +3453,64 @@ namespace fheroes2
 
         size_t GetMaximumICNIndex( int id )
         {
-            if ( _icnVsSprite[id].empty() && !LoadModifiedICN( id ) ) {
+            ResourceUsage & usage = _icnUsage[id];
+            touchResource( usage );
+
+            if ( !_icnVsSprite[id].empty() ) {
+                ++_cacheStatistics.hitCount;
+                return _icnVsSprite[id].size();
+            }
+
+            ++_cacheStatistics.missCount;
+
+            // Time of nested loading is already included into the time of the outer one
+            const Time loadingTime;
+            ++_loadingDepth;
+
+            if ( !LoadModifiedICN( id ) ) {
                 LoadOriginalICN( id );
             }
 
+            // Sprites lose their spans when modified, so spans are built only when all the sprites are ready.
+            // Sprites decoded in background already have them unless they have been modified.
+            for ( Sprite & sprite : _icnVsSprite[id] ) {
+                if ( sprite.spans() == nullptr ) {
+                    sprite.updateSpans();
+                }
+            }
+
+            --_loadingDepth;
+            if ( _loadingDepth == 0 ) {
+                _cacheStatistics.decodeTime += loadingTime.get();
+            }
+
+            updateResourceSize( usage, getImagesMemorySize( _icnVsSprite[id] ) );
+
             return _icnVsSprite[id].size();
         }
 
         size_t GetMaximumTILIndex( int id )
         {
-            if ( _tilVsImage[id].empty() ) {
+            touchResource( _tilUsage[id] );
+
+            if ( !_tilVsImage[id].empty() ) {
+                ++_cacheStatistics.hitCount;
+            }
+            else {
+                ++_cacheStatistics.missCount;
+
+                const Time loadingTime;
+
                 _tilVsImage[id].resize( 4 ); // 4 possible sides
 
-                const std::vector<uint8_t> & data = ::AGG::ReadChunk( tilFileName[id] );
+                const ::AGG::ChunkData data = ::AGG::GetChunk( tilFileName[id] );
                 if ( data.size() < headerSize ) {
                     // The important resource is absent! Make sure that you are using the correct version of the game.
                     assert( 0 );
                     return 0;
                 }
 
-                StreamBuf buffer( data );
+                StreamBuf buffer( data.data(), data.size() );
 
                 const uint32_t count = buffer.getLE16();
                 const uint32_t width = buffer.getLE16();
@@ -3242,6 +3542,16 @@ namespace fheroes2
                         currentTIL[i] = Flip( originalTIL[i], horizontalFlip, verticalFlip );
                     }
                 }
+
+                if ( _loadingDepth == 0 ) {
+                    _cacheStatistics.decodeTime += loadingTime.get();
+                }
+
+                size_t memorySize = 0;
+                for ( const std::vector<Image> & images : _tilVsImage[id] ) {
+                    memorySize += getImagesMemorySize( images );
+                }
+                updateResourceSize( _tilUsage[id], memorySize );
             }
 
             return _tilVsImage[id][0].size();
@@ -3488,5 +3798,93 @@ namespace fheroes2
 
             return false;
         }
+
+        void preloadICNs( const std::vector<int> & icnIds )
+        {
+            for ( const int icnId : icnIds ) {
+                // Generated ICNs have no files to decode
+                if ( icnId > ICN::UNKNOWN && icnId < ICN::LAST_VALID_FILE_ICN && _icnVsSprite[icnId].empty() ) {
+                    _asyncICNDecoder.push( icnId );
+                }
+            }
+        }
+
+        void stopICNDecoding()
+        {
+            _asyncICNDecoder.stop();
+        }
+
+        void setCacheMemoryLimit( const size_t limit )
+        {
+            _cacheMemoryLimit = limit;
+        }
+
+        void trimCache()
+        {
+            _asyncICNDecoder.clearUnused();
+
+            if ( _cacheMemoryLimit > 0 && _cacheStatistics.residentSize > _cacheMemoryLimit ) {
+                // Negative values are used for TIL ids to keep both kinds of resources in one list
+                std::vector<std::pair<uint64_t, int>> candidates;
+
+                for ( size_t icnId = 0; icnId < _icnUsage.size(); ++icnId ) {
+                    const ResourceUsage & usage = _icnUsage[icnId];
+                    if ( usage.size > 0 && usage.pinCount == 0 && isEvictableICN( static_cast<int>( icnId ) ) ) {
+                        candidates.emplace_back( usage.lastAccess, static_cast<int>( icnId ) );
+                    }
+                }
+
+                for ( size_t tilId = 0; tilId < _tilUsage.size(); ++tilId ) {
+                    if ( _tilUsage[tilId].size > 0 ) {
+                        candidates.emplace_back( _tilUsage[tilId].lastAccess, -static_cast<int>( tilId ) - 1 );
+                    }
+                }
+
+                std::sort( candidates.begin(), candidates.end() );
+
+                for ( const std::pair<uint64_t, int> & candidate : candidates ) {
+                    if ( _cacheStatistics.residentSize <= _cacheMemoryLimit ) {
+                        break;
+                    }
+
+                    if ( candidate.second >= 0 ) {
+                        const int icnId = candidate.second;
+
+                        std::vector<Sprite>().swap( _icnVsSprite[icnId] );
+                        _icnVsScaledSprite.erase( icnId );
+                        updateResourceSize( _icnUsage[icnId], 0 );
+                    }
+                    else {
+                        const int tilId = -candidate.second - 1;
+
+                        std::vector<std::vector<Image>>().swap( _tilVsImage[tilId] );
+                        updateResourceSize( _tilUsage[tilId], 0 );
+                    }
+
+                    ++_cacheStatistics.evictionCount;
+                }
+            }
+
+            DEBUG_LOG( DBG_ENGINE, DBG_INFO,
+                       "Image cache: " << _cacheStatistics.residentSize / 1024 << " KB resident, limit " << _cacheMemoryLimit / 1024 << " KB, hits "
+                                       << _cacheStatistics.hitCount << ", misses " << _cacheStatistics.missCount << ", evictions "
+                                       << _cacheStatistics.evictionCount << ", decoding time " << _cacheStatistics.decodeTime << " s" );
+        }
+
+        ICNPin::ICNPin( const int icnId )
+            : _icnId( icnId )
+        {
+            if ( IsValidICNId( _icnId ) ) {
+                ++_icnUsage[_icnId].pinCount;
+            }
+        }
+
+        ICNPin::~ICNPin()
+        {
+            if ( IsValidICNId( _icnId ) ) {
+                assert( _icnUsage[_icnId].pinCount > 0 );
+                --_icnUsage[_icnId].pinCount;
+            }
+        }
     }
 }
@@ -20,7 +20,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 namespace fheroes2
 {
@@ -35,6 +37,10 @@ namespace fheroes2
         const Sprite & GetICN( int icnId, uint32_t index );
         uint32_t GetICNCount( int icnId );
 
+        // Starts decoding of the given ICNs in background threads, so they are ready or at least partially decoded when they are requested.
+        // Use it at the beginning of screens which need many ICNs at once.
+        void preloadICNs( const std::vector<int> & icnIds );
+
         // shapeId could be 0, 1, 2 or 3 only
         const Image & GetTIL( int tilId, uint32_t index, uint32_t shapeId );
         const Sprite & GetLetter( uint32_t character, uint32_t fontType );
@@ -51,5 +57,29 @@ namespace fheroes2
         void updateAlphabet( const SupportedLanguage language, const bool loadOriginalAlphabet );
 
         bool isAlphabetSupported( const SupportedLanguage language );
+
+        // Stops the threads which decode ICN images in background. It must be called before the AGG files are closed.
+        void stopICNDecoding();
+
+        // Sets the amount of memory in bytes which loaded ICN and TIL images may occupy. 0 means that there is no limit.
+        void setCacheMemoryLimit( const size_t limit );
+
+        // Frees the least recently used ICN and TIL images which are not pinned until the occupied memory fits the limit. References to the freed
+        // images become invalid, so this function must be called only between screens, when no screen keeps references to the images.
+        void trimCache();
+
+        // While an object of this class exists the images of the given ICN are not freed by trimCache().
+        // Use it for long living objects which keep references to the images.
+        class ICNPin
+        {
+        public:
+            explicit ICNPin( const int icnId );
+            ICNPin( const ICNPin & ) = delete;
+            ICNPin & operator=( const ICNPin & ) = delete;
+            ~ICNPin();
+
+        private:
+            const int _icnId;
+        };
     }
 }
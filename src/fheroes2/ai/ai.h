@@ -103,6 +103,7 @@ namespace AI
 
         virtual void Reset();
         virtual void resetPathfinder() = 0;
+        virtual void invalidatePathfinder( const int32_t tileIndex ) = 0;
 
         virtual ~Base() = default;
 
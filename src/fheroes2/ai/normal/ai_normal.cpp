@@ -33,6 +33,19 @@ namespace AI
     void Normal::resetPathfinder()
     {
         _pathfinder.reset();
+
+        for ( auto & pathfinder : _heroPathfinders ) {
+            pathfinder.second->reset();
+        }
+    }
+
+    void Normal::invalidatePathfinder( const int32_t tileIndex )
+    {
+        _pathfinder.invalidateTile( tileIndex );
+
+        for ( auto & pathfinder : _heroPathfinders ) {
+            pathfinder.second->invalidateTile( tileIndex );
+        }
     }
 
     void Normal::revealFog( const Maps::Tiles & tile )
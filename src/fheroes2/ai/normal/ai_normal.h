@@ -24,6 +24,8 @@
 #include "ai.h"
 #include "world_pathfinding.h"
 
+#include <map>
+#include <memory>
 #include <set>
 
 struct KingdomCastles;
@@ -154,6 +156,8 @@ namespace AI
         const Rand::DeterministicRandomGenerator * _randomGenerator = nullptr;
     };
 
+    class PathfinderWorkers;
+
     class Normal : public Base
     {
     public:
@@ -174,8 +178,9 @@ namespace AI
         std::vector<AICastle> getSortedCastleList( const KingdomCastles & castles, const std::set<int> & castlesInDanger );
 
         double getObjectValue( const Heroes & hero, const int index, const double valueToIgnore, const uint32_t distanceToObject ) const;
-        int getPriorityTarget( const HeroToMove & heroInfo, double & maxPriority );
+        int getPriorityTarget( const HeroToMove & heroInfo, double & maxPriority, AIWorldPathfinder & pathfinder );
         void resetPathfinder() override;
+        void invalidatePathfinder( const int32_t tileIndex ) override;
 
     private:
         // following data won't be saved/serialized
@@ -183,7 +188,13 @@ namespace AI
         std::vector<IndexObject> _mapObjects;
         std::vector<RegionStats> _regions;
         AIWorldPathfinder _pathfinder;
-        BattlePlanner _battlePlanner;
+        // Separate pathfinder for every hero being planned (by hero ID), so the map can be evaluated for all of them in parallel and the
+        // results can be repaired after the moves of other heroes instead of being evaluated from scratch
+        std::map<int, std::unique_ptr<AIWorldPathfinder>> _heroPathfinders;
+
+        // Evaluates the map for every given hero using the given worker threads, returns the pathfinders of these heroes in the same order.
+        // The world must not be modified during this call.
+        std::vector<AIWorldPathfinder *> evaluateHeroPaths( const std::vector<HeroToMove> & heroes, PathfinderWorkers & workers );
 
         double getHunterObjectValue( const Heroes & hero, const int index, const double valueToIgnore, const uint32_t distanceToObject ) const;
 
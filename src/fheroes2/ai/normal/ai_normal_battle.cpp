@@ -817,7 +817,10 @@ namespace AI
         board->Reset();
         board->SetScanPassability( currentUnit );
 
-        const Actions & plannedActions = _battlePlanner.planUnitTurn( arena, currentUnit );
+        // Battles can be run simultaneously on several threads, every thread has its own planner
+        thread_local BattlePlanner battlePlanner;
+
+        const Actions & plannedActions = battlePlanner.planUnitTurn( arena, currentUnit );
         actions.insert( actions.end(), plannedActions.begin(), plannedActions.end() );
 
         // Do not end the turn if we only cast a spell
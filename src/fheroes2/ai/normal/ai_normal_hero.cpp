@@ -19,6 +19,12 @@
  ***************************************************************************/
 
 #include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 #include "ai_normal.h"
 #include "game.h"
@@ -1048,7 +1054,7 @@ namespace AI
         return 0;
     }
 
-    int AI::Normal::getPriorityTarget( const HeroToMove & heroInfo, double & maxPriority )
+    int AI::Normal::getPriorityTarget( const HeroToMove & heroInfo, double & maxPriority, AIWorldPathfinder & pathfinder )
     {
         const Heroes & hero = *heroInfo.hero;
         const double lowestPossibleValue = -1.0 * Maps::Ground::slowestMovePenalty * world.getSize();
@@ -1062,11 +1068,11 @@ namespace AI
 #endif
 
         // pre-cache the pathfinder
-        _pathfinder.reEvaluateIfNeeded( hero );
+        pathfinder.reEvaluateIfNeeded( hero );
 
         const uint32_t leftMovePoints = hero.GetMovePoints();
 
-        ObjectValidator objectValidator( hero, _pathfinder );
+        ObjectValidator objectValidator( hero, pathfinder );
         ObjectValueStorage valueStorage( hero, *this, lowestPossibleValue );
 
         for ( size_t idx = 0; idx < _mapObjects.size(); ++idx ) {
@@ -1077,9 +1083,9 @@ namespace AI
                 continue;
 
             if ( objectValidator.isValid( node.first ) ) {
-                uint32_t dist = _pathfinder.getDistance( node.first );
+                uint32_t dist = pathfinder.getDistance( node.first );
 
-                const uint32_t dimensionDoorDist = AIWorldPathfinder::calculatePathPenalty( _pathfinder.getDimensionDoorPath( hero, node.first ) );
+                const uint32_t dimensionDoorDist = AIWorldPathfinder::calculatePathPenalty( pathfinder.getDimensionDoorPath( hero, node.first ) );
                 if ( dimensionDoorDist && ( !dist || dimensionDoorDist < dist / 2 ) ) {
                     dist = dimensionDoorDist;
                 }
@@ -1089,7 +1095,7 @@ namespace AI
 
                 double value = valueStorage.value( node, dist );
 
-                const std::vector<IndexObject> & list = _pathfinder.getObjectsOnTheWay( node.first );
+                const std::vector<IndexObject> & list = pathfinder.getObjectsOnTheWay( node.first );
                 for ( const IndexObject & pair : list ) {
                     if ( objectValidator.isValid( pair.first ) && std::binary_search( _mapObjects.begin(), _mapObjects.end(), pair ) ) {
                         const double extraValue = valueStorage.value( pair, 0 ); // object is on the way, we don't loose any movement points.
@@ -1136,13 +1142,177 @@ namespace AI
                        hero.GetName() << ": priority selected: " << priorityTarget << " value is " << maxPriority << " (" << MP2::StringObject( objectType ) << ")" );
         }
         else if ( !heroInPatrolMode ) {
-            priorityTarget = _pathfinder.getFogDiscoveryTile( hero );
+            priorityTarget = pathfinder.getFogDiscoveryTile( hero );
             DEBUG_LOG( DBG_AI, DBG_INFO, hero.GetName() << " can't find an object. Scouting the fog of war at " << priorityTarget );
         }
 
         return priorityTarget;
     }
 
+    // Worker threads which live during the whole turn of heroes, so they are not created again for every evaluation of the map
+    class PathfinderWorkers
+    {
+    public:
+        PathfinderWorkers()
+        {
+            // The current thread is also used as one of the workers
+            const uint32_t coreCount = std::thread::hardware_concurrency();
+
+            for ( uint32_t i = 1; i < coreCount; ++i ) {
+                _workers.emplace_back( PathfinderWorkers::_workerThread, this );
+            }
+        }
+
+        PathfinderWorkers( const PathfinderWorkers & ) = delete;
+
+        ~PathfinderWorkers()
+        {
+            {
+                std::lock_guard<std::mutex> mutexLock( _mutex );
+
+                _exitFlag = true;
+                _workerNotification.notify_all();
+            }
+
+            for ( std::thread & worker : _workers ) {
+                worker.join();
+            }
+        }
+
+        PathfinderWorkers & operator=( const PathfinderWorkers & ) = delete;
+
+        // Calls the task for every index from 0 to taskCount - 1 using all the workers and the current thread. Returns when all the tasks are done.
+        void run( const std::function<void( size_t )> & task, const size_t taskCount )
+        {
+            {
+                std::lock_guard<std::mutex> mutexLock( _mutex );
+
+                _task = &task;
+                _taskCount = taskCount;
+                _nextTask = 0;
+                ++_taskGeneration;
+
+                _workerNotification.notify_all();
+            }
+
+            _runTasks( task, taskCount );
+
+            std::unique_lock<std::mutex> mutexLock( _mutex );
+            _masterNotification.wait( mutexLock, [this] { return _activeWorkers == 0; } );
+
+            // Workers which have not woken up yet must not take the task which is going to be destroyed
+            _task = nullptr;
+        }
+
+    private:
+        std::vector<std::thread> _workers;
+        std::mutex _mutex;
+
+        std::condition_variable _workerNotification;
+        std::condition_variable _masterNotification;
+
+        const std::function<void( size_t )> * _task = nullptr;
+        size_t _taskCount = 0;
+        std::atomic<size_t> _nextTask{ 0 };
+        uint32_t _taskGeneration = 0;
+        uint32_t _activeWorkers = 0;
+
+        bool _exitFlag = false;
+
+        void _runTasks( const std::function<void( size_t )> & task, const size_t taskCount )
+        {
+            for ( size_t i = _nextTask++; i < taskCount; i = _nextTask++ ) {
+                task( i );
+            }
+        }
+
+        static void _workerThread( PathfinderWorkers * workers )
+        {
+            assert( workers != nullptr );
+
+            uint32_t lastGeneration = 0;
+
+            while ( true ) {
+                std::unique_lock<std::mutex> mutexLock( workers->_mutex );
+                workers->_workerNotification.wait( mutexLock, [workers, lastGeneration] {
+                    return workers->_exitFlag || ( workers->_task != nullptr && workers->_taskGeneration != lastGeneration );
+                } );
+
+                if ( workers->_exitFlag ) {
+                    break;
+                }
+
+                lastGeneration = workers->_taskGeneration;
+
+                const std::function<void( size_t )> & task = *workers->_task;
+                const size_t taskCount = workers->_taskCount;
+                ++workers->_activeWorkers;
+
+                mutexLock.unlock();
+
+                workers->_runTasks( task, taskCount );
+
+                mutexLock.lock();
+
+                --workers->_activeWorkers;
+                if ( workers->_activeWorkers == 0 ) {
+                    workers->_masterNotification.notify_one();
+                }
+            }
+        }
+    };
+
+    std::vector<AIWorldPathfinder *> Normal::evaluateHeroPaths( const std::vector<HeroToMove> & heroes, PathfinderWorkers & workers )
+    {
+        struct PathSettings
+        {
+            int start;
+            int color;
+            double armyStrength;
+            uint8_t skill;
+            uint32_t movePoints;
+            uint32_t maxMovePoints;
+        };
+
+        const double armyStrengthMultiplier = _pathfinder.getCurrentArmyStrengthMultiplier();
+
+        // Heroes are accessed only from the current thread, worker threads use the prepared settings
+        std::vector<PathSettings> settings;
+        settings.reserve( heroes.size() );
+
+        std::vector<AIWorldPathfinder *> pathfinders;
+        pathfinders.reserve( heroes.size() );
+
+        for ( const HeroToMove & heroInfo : heroes ) {
+            const Heroes & hero = *heroInfo.hero;
+
+            settings.push_back( { hero.GetIndex(), hero.GetColor(), hero.GetArmy().GetStrength(),
+                                  static_cast<uint8_t>( hero.GetLevelSkill( Skill::Secondary::PATHFINDING ) ), hero.GetMovePoints(), hero.GetMaxMovePoints() } );
+
+            std::unique_ptr<AIWorldPathfinder> & pathfinder = _heroPathfinders[hero.GetID()];
+            if ( !pathfinder ) {
+                pathfinder.reset( new AIWorldPathfinder( armyStrengthMultiplier ) );
+                pathfinder->reset();
+            }
+
+            pathfinder->setArmyStrengthMultiplier( armyStrengthMultiplier );
+            pathfinders.push_back( pathfinder.get() );
+        }
+
+        // Worker threads must not modify the world, so all the army strength values they may need are calculated in advance
+        world.updateTileArmyStrengthCache();
+
+        const std::function<void( size_t )> evaluatePaths = [&settings, &pathfinders]( const size_t i ) {
+            const PathSettings & setting = settings[i];
+
+            pathfinders[i]->reEvaluateIfNeeded( setting.start, setting.color, setting.armyStrength, setting.skill, setting.movePoints, setting.maxMovePoints );
+        };
+
+        workers.run( evaluatePaths, settings.size() );
+
+        return pathfinders;
+    }
+
     void Normal::HeroesActionComplete( Heroes & hero )
     {
         Castle * castle = hero.inCastleMutable();
@@ -1169,19 +1339,29 @@ namespace AI
         const int monsterStrengthMultiplierCount = 2;
         const double monsterStrengthMultipliers[monsterStrengthMultiplierCount] = { ARMY_ADVANTAGE_MEDIUM, ARMY_ADVANTAGE_SMALL };
 
+        PathfinderWorkers workers;
+
         while ( !availableHeroes.empty() ) {
             Heroes * bestHero = availableHeroes.front().hero;
             double maxPriority = 0;
             int bestTargetIndex = -1;
 
+            std::vector<AIWorldPathfinder *> heroPathfinders;
+            // The map has been already evaluated for the selected hero by this pathfinder
+            AIWorldPathfinder * bestPathfinder = nullptr;
+
             while ( true ) {
-                for ( const HeroToMove & heroInfo : availableHeroes ) {
+                heroPathfinders = evaluateHeroPaths( availableHeroes, workers );
+
+                for ( size_t i = 0; i < availableHeroes.size(); ++i ) {
+                    const HeroToMove & heroInfo = availableHeroes[i];
                     double priority = -1;
-                    const int targetIndex = getPriorityTarget( heroInfo, priority );
+                    const int targetIndex = getPriorityTarget( heroInfo, priority, *heroPathfinders[i] );
                     if ( targetIndex != -1 && ( priority > maxPriority || bestTargetIndex == -1 ) ) {
                         maxPriority = priority;
                         bestTargetIndex = targetIndex;
                         bestHero = heroInfo.hero;
+                        bestPathfinder = heroPathfinders[i];
                     }
                 }
 
@@ -1207,20 +1387,23 @@ namespace AI
 
             if ( bestTargetIndex == -1 ) {
                 // Possibly heroes have nothing to do because one of them is blocking the way. Move a hero randomly and see what happens.
-                for ( HeroToMove & heroInfo : availableHeroes ) {
+                for ( size_t i = 0; i < availableHeroes.size(); ++i ) {
+                    const HeroToMove & heroInfo = availableHeroes[i];
                     // Skip heroes who are in castles or on patrol.
                     if ( heroInfo.patrolCenter >= 0 && heroInfo.hero->inCastle() != nullptr ) {
                         continue;
                     }
 
-                    if ( !_pathfinder.isHeroPossiblyBlockingWay( *heroInfo.hero ) ) {
+                    AIWorldPathfinder & pathfinder = *heroPathfinders[i];
+                    if ( !pathfinder.isHeroPossiblyBlockingWay( *heroInfo.hero ) ) {
                         continue;
                     }
 
-                    const int targetIndex = _pathfinder.getNearestTileToMove( *heroInfo.hero );
+                    const int targetIndex = pathfinder.getNearestTileToMove( *heroInfo.hero );
                     if ( targetIndex != -1 ) {
                         bestTargetIndex = targetIndex;
                         bestHero = heroInfo.hero;
+                        bestPathfinder = &pathfinder;
 
                         DEBUG_LOG( DBG_AI, DBG_INFO, bestHero->GetName() << " may be blocking the way. Moving to " << bestTargetIndex );
 
@@ -1235,18 +1418,19 @@ namespace AI
                 }
             }
 
+            assert( bestPathfinder != nullptr );
+
             const size_t heroesBefore = heroes.size();
-            _pathfinder.reEvaluateIfNeeded( *bestHero );
 
             // check if we want to use Dimension Door spell or move regularly
-            const std::list<Route::Step> & dimensionPath = _pathfinder.getDimensionDoorPath( *bestHero, bestTargetIndex );
+            const std::list<Route::Step> & dimensionPath = bestPathfinder->getDimensionDoorPath( *bestHero, bestTargetIndex );
             const uint32_t dimensionDoorDistance = AIWorldPathfinder::calculatePathPenalty( dimensionPath );
-            const uint32_t moveDistance = _pathfinder.getDistance( bestTargetIndex );
+            const uint32_t moveDistance = bestPathfinder->getDistance( bestTargetIndex );
             if ( dimensionDoorDistance && ( !moveDistance || dimensionDoorDistance < moveDistance / 2 ) ) {
                 HeroesCastDimensionDoor( *bestHero, dimensionPath.front().GetIndex() );
             }
             else {
-                bestHero->GetPath().setPath( _pathfinder.buildPath( bestTargetIndex ), bestTargetIndex );
+                bestHero->GetPath().setPath( bestPathfinder->buildPath( bestTargetIndex ), bestTargetIndex );
 
                 HeroesMove( *bestHero );
             }
@@ -18,6 +18,7 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <algorithm>
 #include <cassert>
 
 #include "agg.h"
@@ -196,6 +197,8 @@ namespace AI
 
             const double attackerStrength = enemy.second->GetStrength();
 
+            std::vector<int> threatenedCastles;
+
             for ( const Castle * castle : castles ) {
                 if ( !castle )
                     continue;
@@ -205,15 +208,29 @@ namespace AI
                 if ( Maps::GetApproximateDistance( enemy.first, castleIndex ) * Maps::Ground::roadPenalty > threatDistanceLimit )
                     continue;
 
+                // the straight line can be short, but the army may have to go around mountains or the sea
+                if ( world.getRegionDistance( enemy.first, castleIndex ) > threatDistanceLimit )
+                    continue;
+
                 const double defenders = castle->GetArmy().GetStrength();
 
                 const double attackerThreat = attackerStrength - defenders;
                 if ( attackerThreat > 0 ) {
-                    const uint32_t dist = _pathfinder.getDistance( enemy.first, castleIndex, myColor, attackerStrength );
-                    if ( dist && dist < threatDistanceLimit ) {
-                        // castle is under threat
-                        castlesInDanger.insert( castleIndex );
-                    }
+                    threatenedCastles.push_back( castleIndex );
+                }
+            }
+
+            if ( threatenedCastles.empty() )
+                continue;
+
+            // Distances to all the castles are calculated in one pass which doesn't go further than the threat distance
+            const std::vector<uint32_t> distances = _pathfinder.getDistances( enemy.first, threatenedCastles, myColor, attackerStrength, threatDistanceLimit );
+
+            for ( size_t i = 0; i < threatenedCastles.size(); ++i ) {
+                const uint32_t dist = distances[i];
+                if ( dist && dist < threatDistanceLimit ) {
+                    // castle is under threat
+                    castlesInDanger.insert( threatenedCastles[i] );
                 }
             }
         }
@@ -235,9 +252,25 @@ namespace AI
 
         AGG::PlayMusic( MUS::COMPUTER_TURN, true, true );
 
+        // Other kingdoms' armies could have changed since the previous turn
+        world.resetTileArmyStrengthCache();
+
         KingdomHeroes & heroes = kingdom.GetHeroes();
         const KingdomCastles & castles = kingdom.GetCastles();
 
+        // Pathfinders of heroes which are not in this kingdom anymore are not needed. The rest are evaluated from scratch, because
+        // they do not track the changes made since the previous turn which do not touch a tile, like the army strength of enemies.
+        for ( auto iter = _heroPathfinders.begin(); iter != _heroPathfinders.end(); ) {
+            const int heroId = iter->first;
+            if ( std::none_of( heroes.begin(), heroes.end(), [heroId]( const Heroes * hero ) { return hero->GetID() == heroId; } ) ) {
+                iter = _heroPathfinders.erase( iter );
+                continue;
+            }
+
+            iter->second->reset();
+            ++iter;
+        }
+
         DEBUG_LOG( DBG_AI, DBG_INFO, Color::String( myColor ) << " starts the turn: " << castles.size() << " castles, " << heroes.size() << " heroes" );
         DEBUG_LOG( DBG_AI, DBG_TRACE, "Funds: " << kingdom.GetFunds().String() );
 
@@ -250,10 +283,9 @@ namespace AI
         _regions.resize( world.getRegionCount() );
 
         for ( int idx = 0; idx < mapSize; ++idx ) {
-            const Maps::Tiles & tile = world.GetTiles( idx );
-            MP2::MapObjectType objectType = tile.GetObject();
+            MP2::MapObjectType objectType = world.getTileObjectType( idx );
 
-            const uint32_t regionID = tile.GetRegion();
+            const uint32_t regionID = world.getTileRegion( idx );
             if ( regionID >= _regions.size() ) {
                 // shouldn't be possible, assert
                 assert( regionID < _regions.size() );
@@ -264,9 +296,10 @@ namespace AI
             if ( objectType != MP2::OBJ_COAST )
                 stats.validObjects.emplace_back( idx, objectType );
 
-            if ( !tile.isFog( myColor ) ) {
+            if ( !world.isFogTile( idx, myColor ) ) {
                 _mapObjects.emplace_back( idx, objectType );
 
+                const Maps::Tiles & tile = world.GetTiles( idx );
                 const int tileColor = tile.QuantityColor();
                 if ( objectType == MP2::OBJ_HEROES ) {
                     const Heroes * hero = tile.GetHeroes();
@@ -314,7 +347,7 @@ namespace AI
                     }
                 }
                 else if ( objectType == MP2::OBJ_MONSTER ) {
-                    stats.averageMonster += Army( tile ).GetStrength();
+                    stats.averageMonster += world.getTileArmyStrength( idx );
                     ++stats.monsterCount;
                 }
             }
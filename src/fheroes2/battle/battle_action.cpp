@@ -592,7 +592,7 @@ void Battle::Arena::TargetsApplyDamage( Unit & attacker, const Unit & /*defender
     }
 }
 
-Battle::TargetsInfo Battle::Arena::GetTargetsForDamage( const Unit & attacker, Unit & defender, const int32_t dst, const int dir )
+Battle::TargetsInfo Battle::Arena::GetTargetsForDamage( const Unit & attacker, Unit & defender, const int32_t dst, const int dir ) const
 {
     // The attacked unit should be located on the attacked cell
     assert( defender.GetHeadIndex() == dst || defender.GetTailIndex() == dst );
@@ -607,7 +607,7 @@ Battle::TargetsInfo Battle::Arena::GetTargetsForDamage( const Unit & attacker, U
     res.damage = attacker.GetDamage( defender );
 
     // Genie special attack
-    if ( attacker.GetID() == Monster::GENIE && Rand::Get( 1, 10 ) == 2 && defender.GetHitPoints() / 2 > res.damage ) {
+    if ( attacker.GetID() == Monster::GENIE && _randomGenerator.Get( 1, 10 ) == 2 && defender.GetHitPoints() / 2 > res.damage ) {
         // Replaces the damage, not adding to it
         if ( defender.GetCount() == 1 ) {
             res.damage = defender.GetHitPoints();
@@ -711,7 +711,7 @@ std::vector<Battle::Unit *> Battle::Arena::FindChainLightningTargetIndexes( cons
         for ( size_t i = 0; i < foundTroops.size(); ++i ) {
             const int32_t resist = foundTroops[i]->GetMagicResist( Spell::CHAINLIGHTNING, heroSpellPower, hero );
             assert( resist >= 0 );
-            if ( resist < static_cast<int32_t>( Rand::Get( 1, 100 ) ) ) {
+            if ( resist < static_cast<int32_t>( _randomGenerator.Get( 1, 100 ) ) ) {
                 ignoredTroops.push_back( foundTroops[i] );
                 result.push_back( foundTroops[i] );
                 foundTroops.erase( foundTroops.begin() + i );
@@ -1091,7 +1091,7 @@ void Battle::Arena::ApplyActionSpellEarthQuake( const Command & /*cmd*/ )
         const int wallCondition = board[position].GetObject();
 
         if ( wallCondition > 0 ) {
-            uint32_t wallDamage = Rand::Get( range.first, range.second );
+            uint32_t wallDamage = _randomGenerator.Get( range.first, range.second );
 
             if ( wallDamage > static_cast<uint32_t>( wallCondition ) ) {
                 wallDamage = wallCondition;
@@ -1101,9 +1101,9 @@ void Battle::Arena::ApplyActionSpellEarthQuake( const Command & /*cmd*/ )
         }
     }
 
-    if ( towers[0] && towers[0]->isValid() && Rand::Get( 1 ) )
+    if ( towers[0] && towers[0]->isValid() && _randomGenerator.Get( 1 ) )
         towers[0]->SetDestroy();
-    if ( towers[2] && towers[2]->isValid() && Rand::Get( 1 ) )
+    if ( towers[2] && towers[2]->isValid() && _randomGenerator.Get( 1 ) )
         towers[2]->SetDestroy();
 
     DEBUG_LOG( DBG_BATTLE, DBG_TRACE, "spell: " << Spell( Spell::EARTHQUAKE ).GetName() << ", targets: " << targets.size() );
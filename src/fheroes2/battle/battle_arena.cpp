@@ -52,7 +52,8 @@
 
 namespace Battle
 {
-    Arena * arena = nullptr;
+    // Every thread has its own current battle, so independent battles can be run simultaneously (e.g. by the battle simulator)
+    thread_local Arena * arena = nullptr;
 }
 
 namespace
@@ -25,6 +25,7 @@
 #include <array>
 #include <cassert>
 #include <cstdint>
+#include <deque>
 #include <iterator>
 #include <set>
 
@@ -205,10 +206,124 @@ void Battle::Board::SetScanPassability( const Unit & unit )
             }
         }
     }
+    else if ( unit.isWide() ) {
+        ScanPassabilityForWideUnit( unit );
+    }
     else {
-        // Set passable cells.
-        for ( const int32_t idx : GetDistanceIndexes( unit.GetHeadIndex(), unit.GetSpeed() ) ) {
-            GetPath( unit, Position::GetPosition( unit, idx ), false );
+        ScanPassabilityForUnit( unit );
+    }
+}
+
+void Battle::Board::ScanPassabilityForUnit( const Unit & unit )
+{
+    const Castle * castle = Arena::GetCastle();
+    const bool isMoatBuilt = castle && castle->isBuild( BUILD_MOAT );
+
+    const uint32_t speed = unit.GetSpeed();
+
+    // Number of steps to reach the cell, cells are explored in ascending order of the number of steps
+    std::vector<uint32_t> steps( ARENASIZE, UINT32_MAX );
+    Indexes cellsToExplore;
+    cellsToExplore.reserve( ARENASIZE );
+
+    steps[unit.GetHeadIndex()] = 0;
+    cellsToExplore.push_back( unit.GetHeadIndex() );
+
+    for ( size_t i = 0; i < cellsToExplore.size(); ++i ) {
+        const int32_t currentCellId = cellsToExplore[i];
+        const uint32_t nextSteps = steps[currentCellId] + 1;
+
+        if ( nextSteps > speed ) {
+            break;
+        }
+
+        for ( const int32_t cellId : GetAroundIndexes( currentCellId ) ) {
+            Cell & cell = at( cellId );
+
+            if ( steps[cellId] != UINT32_MAX || !cell.isPassableFromAdjacent( unit, at( currentCellId ) ) ) {
+                continue;
+            }
+
+            steps[cellId] = nextSteps;
+            cell.setReachableForHead();
+
+            // Unit can step into the moat, but cannot pass through it
+            if ( isMoatBuilt && isMoatIndex( cellId, unit ) ) {
+                continue;
+            }
+
+            cellsToExplore.push_back( cellId );
+        }
+    }
+}
+
+void Battle::Board::ScanPassabilityForWideUnit( const Unit & unit )
+{
+    const Castle * castle = Arena::GetCastle();
+    const bool isMoatBuilt = castle && castle->isBuild( BUILD_MOAT );
+
+    const uint32_t speed = unit.GetSpeed();
+
+    // Every position of a wide unit is defined by the head cell and the direction of the unit (tail cell is to the right of the head cell
+    // if the unit is directed to the left and vice versa), the node ID is the head cell ID * 2 + 1 for the left direction
+    auto getNodeId = []( const int32_t headCellId, const bool isLeftDirection ) { return headCellId * 2 + ( isLeftDirection ? 1 : 0 ); };
+
+    // Number of steps to reach the position. Turning back is not a movement, so positions reached by turning back are explored first.
+    std::vector<uint32_t> steps( ARENASIZE * 2, UINT32_MAX );
+    std::deque<int32_t> nodesToExplore;
+
+    const int32_t startNodeId = getNodeId( unit.GetHeadIndex(), unit.isReflect() );
+
+    steps[startNodeId] = 0;
+    nodesToExplore.push_back( startNodeId );
+
+    while ( !nodesToExplore.empty() ) {
+        const int32_t currentNodeId = nodesToExplore.front();
+        nodesToExplore.pop_front();
+
+        const int32_t currentHeadCellId = currentNodeId / 2;
+        const bool isCurrentLeftDirection = ( currentNodeId % 2 ) != 0;
+        const int32_t currentTailCellId = isCurrentLeftDirection ? currentHeadCellId + 1 : currentHeadCellId - 1;
+        const uint32_t currentSteps = steps[currentNodeId];
+
+        for ( const int32_t headCellId : GetMoveWideIndexes( currentHeadCellId, isCurrentLeftDirection ) ) {
+            Cell & cell = at( headCellId );
+
+            if ( !cell.isPassableFromAdjacent( unit, at( currentHeadCellId ) ) ) {
+                continue;
+            }
+
+            const bool isLeftDirection = ( GetDirection( currentHeadCellId, headCellId ) & LEFT_SIDE ) != 0;
+            const int32_t tailCellId = isLeftDirection ? headCellId + 1 : headCellId - 1;
+
+            // Turning back is not a movement
+            const bool isTurningBack = headCellId == currentTailCellId;
+            const uint32_t nextSteps = isTurningBack ? currentSteps : currentSteps + 1;
+
+            const int32_t nodeId = getNodeId( headCellId, isLeftDirection );
+            if ( nextSteps > speed || steps[nodeId] <= nextSteps ) {
+                continue;
+            }
+
+            steps[nodeId] = nextSteps;
+
+            cell.setReachableForHead();
+            at( tailCellId ).setReachableForTail();
+
+            // Unit can step into the moat, but cannot pass through it. In the moat it is only allowed to turn back.
+            if ( isMoatBuilt && ( isMoatIndex( headCellId, unit ) || isMoatIndex( tailCellId, unit ) ) ) {
+                if ( ( tailCellId != currentHeadCellId || !isMoatIndex( tailCellId, unit ) )
+                     && ( headCellId != currentTailCellId || !isMoatIndex( headCellId, unit ) ) ) {
+                    continue;
+                }
+            }
+
+            if ( isTurningBack ) {
+                nodesToExplore.push_front( nodeId );
+            }
+            else {
+                nodesToExplore.push_back( nodeId );
+            }
         }
     }
 }
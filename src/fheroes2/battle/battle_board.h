@@ -112,6 +112,11 @@ namespace Battle
     private:
         void SetCobjObject( const int icn, const int32_t dst );
 
+        // Mark all the cells reachable by the unit during the current turn, every cell is processed at most once (twice for wide units,
+        // one time per each direction)
+        void ScanPassabilityForUnit( const Unit & unit );
+        void ScanPassabilityForWideUnit( const Unit & unit );
+
         bool GetPathForUnit( const Unit & unit, const Position & destination, const uint32_t remainingSteps, const int32_t currentCellId,
                              std::vector<bool> & visitedCells, Indexes & result ) const;
         bool GetPathForWideUnit( const Unit & unit, const Position & destination, const uint32_t remainingSteps, const int32_t currentHeadCellId,
@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <vector>
 
 #include "agg.h"
 #include "agg_image.h"
@@ -1049,6 +1050,15 @@ Battle::Interface::Interface( Arena & a, s32 center )
         break;
     }
 
+    // Start decoding of the battlefield and unit images while the rest of the interface is being prepared
+    std::vector<int> icnsToPreload{ icn_cbkg, icn_frng, ICN::TEXTBAR };
+    for ( const Force * force : { &arena.GetForce1(), &arena.GetForce2() } ) {
+        for ( const Unit * unit : *force ) {
+            icnsToPreload.push_back( unit->GetMonsterSprite() );
+        }
+    }
+    fheroes2::AGG::preloadICNs( icnsToPreload );
+
     // hexagon
     sf_hexagon = DrawHexagon( fheroes2::GetColorId( 0x68, 0x8C, 0x04 ) );
     sf_cursor = DrawHexagonShadow( 2 );
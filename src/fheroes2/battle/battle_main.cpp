@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <memory>
 
+#include "agg_image.h"
 #include "ai.h"
 #include "army.h"
 #include "artifact.h"
@@ -325,6 +326,19 @@ Battle::Result Battle::Loader( Army & army1, Army & army2, s32 mapsindex )
 
     DEBUG_LOG( DBG_BATTLE, DBG_INFO, "army1: " << ( result.army1 & RESULT_WINS ? "wins" : "loss" ) << ", army2: " << ( result.army2 & RESULT_WINS ? "wins" : "loss" ) );
 
+    if ( showBattle ) {
+        // Battle images are not needed until the next battle
+        fheroes2::AGG::trimCache();
+    }
+
+    // Armies of the participants have changed, memoized strength values and paths blocked by these armies are no longer valid
+    world.resetTileArmyStrengthCache();
+    world.invalidatePathfinder( mapsindex );
+
+    if ( commander1 ) {
+        world.invalidatePathfinder( commander1->GetIndex() );
+    }
+
     return result;
 }
 
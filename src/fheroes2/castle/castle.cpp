@@ -649,6 +649,9 @@ void Castle::ChangeColor( int cl )
 {
     SetColor( cl );
     army.SetColor( cl );
+
+    // Radar shows the color of the owner on all tiles of the castle
+    world.invalidateRadarTiles( GetIndex(), 3 );
 }
 
 int Castle::GetLevelMageGuild( void ) const
@@ -23,6 +23,7 @@
 
 #include <cassert>
 #include <string>
+#include <vector>
 
 #include "agg.h"
 #include "agg_image.h"
@@ -247,6 +248,13 @@ Castle::CastleDialogReturnValue Castle::OpenDialog( const bool readOnly, const b
     // It's not possible to open town window in read only mode.
     assert( !openConstructionWindow || !readOnly );
 
+    // Start decoding of the town images while the screen is being prepared
+    std::vector<int> icnsToPreload{ ICN::STRIP, ICN::CREST, ICN::SMALLBAR, ICN::TREASURY };
+    for ( const building_t buildingId : fheroes2::getBuildingDrawingPriorities( race, Settings::Get().CurrentFileInfo()._version ) ) {
+        icnsToPreload.push_back( GetICNBuilding( buildingId, race ) );
+    }
+    fheroes2::AGG::preloadICNs( icnsToPreload );
+
     // setup cursor
     const CursorRestorer cursorRestorer( true, Cursor::POINTER );
 
@@ -113,8 +113,13 @@ void Interface::Basic::Redraw( int force )
     const int combinedRedraw = redraw | force;
     const bool hideInterface = conf.ExtGameHideInterface();
 
-    if ( combinedRedraw & REDRAW_GAMEAREA )
+    if ( combinedRedraw & REDRAW_GAMEAREA ) {
         gameArea.Redraw( fheroes2::Display::instance(), LEVEL_ALL );
+        gameArea.ResetTileRedraw();
+    }
+    else if ( combinedRedraw & REDRAW_GAMEAREA_TILES ) {
+        gameArea.RedrawTiles( fheroes2::Display::instance(), LEVEL_ALL );
+    }
 
     if ( ( hideInterface && conf.ShowRadar() ) || ( combinedRedraw & REDRAW_RADAR ) )
         radar.Redraw();
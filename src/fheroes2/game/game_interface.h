@@ -63,6 +63,8 @@ namespace Interface
         REDRAW_BORDER = 0x20,
         REDRAW_GAMEAREA = 0x40,
         REDRAW_CURSOR = 0x80,
+        // only the tiles marked by GameArea::SetTileRedraw()
+        REDRAW_GAMEAREA_TILES = 0x100,
 
         REDRAW_ICONS = REDRAW_HEROES | REDRAW_CASTLES,
         REDRAW_ALL = 0xFF
@@ -21,7 +21,10 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <cstdio>
 #include <ctime>
+#include <memory>
+#include <thread>
 
 #include "campaign_savedata.h"
 #include "dialog.h"
@@ -84,54 +87,149 @@ namespace
     {
         return msg >> hdr.status >> hdr.info >> hdr.gameType;
     }
+
+    // Serialized state of the game which can be written to a file independently of the game itself
+    struct SaveSnapshot
+    {
+        StreamBuf header;
+        ZStreamFile data;
+    };
+
+    std::unique_ptr<SaveSnapshot> CreateSaveSnapshot()
+    {
+        const Settings & conf = Settings::Get();
+        const u16 loadver = Game::GetLoadVersion();
+
+        std::unique_ptr<SaveSnapshot> snapshot( new SaveSnapshot );
+
+        // raw info content
+        snapshot->header.setbigendian( true );
+        snapshot->header << static_cast<uint8_t>( SAV2ID3 >> 8 ) << static_cast<uint8_t>( SAV2ID3 & 0xFF ) << std::to_string( loadver ) << loadver
+                         << HeaderSAV( conf.CurrentFileInfo(), conf.GameType() );
+
+        // game data content, to be zipped
+        ZStreamFile & fz = snapshot->data;
+        fz.setbigendian( true );
+
+        fz << loadver << World::Get() << Settings::Get() << GameOver::Result::Get();
+
+        if ( conf.isCampaignGameType() )
+            fz << Campaign::CampaignSaveData::Get();
+
+        fz << SAV2ID3; // eof marker
+
+        return snapshot;
+    }
+
+    bool WriteSaveSnapshot( const SaveSnapshot & snapshot, const std::string & fn )
+    {
+        StreamFile fs;
+        fs.setbigendian( true );
+
+        if ( !fs.open( fn, "wb" ) ) {
+            DEBUG_LOG( DBG_GAME, DBG_WARN, fn << ", error open" );
+            return false;
+        }
+
+        fs.putRaw( reinterpret_cast<const char *>( snapshot.header.data() ), snapshot.header.size() );
+        fs.close();
+
+        return !snapshot.data.fail() && snapshot.data.write( fn, true );
+    }
+
+    // Autosave data is compressed and written by a background thread, so the game is not stalled by it. Only one autosave
+    // can be written at a time, any other access to the save files has to wait until the pending autosave is finished.
+    class AutoSaveWriter
+    {
+    public:
+        AutoSaveWriter() = default;
+        AutoSaveWriter( const AutoSaveWriter & ) = delete;
+        AutoSaveWriter & operator=( const AutoSaveWriter & ) = delete;
+
+        ~AutoSaveWriter()
+        {
+            wait();
+        }
+
+        void wait()
+        {
+            if ( _thread.joinable() ) {
+                _thread.join();
+            }
+        }
+
+        void write( std::unique_ptr<SaveSnapshot> snapshot, const std::string & fn )
+        {
+            wait();
+
+            std::shared_ptr<SaveSnapshot> data( std::move( snapshot ) );
+
+            _thread = std::thread( [data, fn]() {
+                // The file is written under a temporary name and then renamed, so the previous autosave stays intact until the new one is complete
+                const std::string tempFileName = fn + ".tmp";
+
+                if ( !WriteSaveSnapshot( *data, tempFileName ) ) {
+                    ERROR_LOG( "Failed to write the autosave file " << tempFileName );
+                    System::Unlink( tempFileName );
+                    return;
+                }
+
+                if ( std::rename( tempFileName.c_str(), fn.c_str() ) != 0 ) {
+                    // Some platforms do not allow to replace an existing file by renaming
+                    System::Unlink( fn );
+
+                    if ( std::rename( tempFileName.c_str(), fn.c_str() ) != 0 ) {
+                        ERROR_LOG( "Failed to rename " << tempFileName << " to " << fn );
+                    }
+                }
+            } );
+        }
+
+    private:
+        std::thread _thread;
+    };
+
+    AutoSaveWriter autoSaveWriter;
 }
 
 bool Game::AutoSave()
 {
-    return Game::Save( System::ConcatePath( GetSaveDir(), "AUTOSAVE" + GetSaveFileExtension() ) );
+    const std::string fn = System::ConcatePath( GetSaveDir(), "AUTOSAVE" + GetSaveFileExtension() );
+    DEBUG_LOG( DBG_GAME, DBG_INFO, fn );
+
+    std::unique_ptr<SaveSnapshot> snapshot = CreateSaveSnapshot();
+    if ( snapshot->data.fail() ) {
+        DEBUG_LOG( DBG_GAME, DBG_WARN, fn << ", error serialize" );
+        return false;
+    }
+
+    autoSaveWriter.write( std::move( snapshot ), fn );
+
+    return true;
 }
 
 bool Game::Save( const std::string & fn )
 {
     DEBUG_LOG( DBG_GAME, DBG_INFO, fn );
-    const bool autosave = ( System::GetBasename( fn ) == "AUTOSAVE" + GetSaveFileExtension() );
-    const Settings & conf = Settings::Get();
 
-    StreamFile fs;
-    fs.setbigendian( true );
+    autoSaveWriter.wait();
 
-    if ( !fs.open( fn, "wb" ) ) {
-        DEBUG_LOG( DBG_GAME, DBG_WARN, fn << ", error open" );
+    if ( !WriteSaveSnapshot( *CreateSaveSnapshot(), fn ) )
         return false;
-    }
 
-    u16 loadver = GetLoadVersion();
+    const bool autosave = ( System::GetBasename( fn ) == "AUTOSAVE" + GetSaveFileExtension() );
     if ( !autosave )
         Game::SetLastSavename( fn );
 
-    // raw info content
-    fs << static_cast<uint8_t>( SAV2ID3 >> 8 ) << static_cast<uint8_t>( SAV2ID3 & 0xFF ) << std::to_string( loadver ) << loadver
-       << HeaderSAV( conf.CurrentFileInfo(), conf.GameType() );
-    fs.close();
-
-    ZStreamFile fz;
-    fz.setbigendian( true );
-
-    // zip game data content
-    fz << loadver << World::Get() << Settings::Get() << GameOver::Result::Get();
-
-    if ( conf.isCampaignGameType() )
-        fz << Campaign::CampaignSaveData::Get();
-
-    fz << SAV2ID3; // eof marker
-
-    return !fz.fail() && fz.write( fn, true );
+    return true;
 }
 
 fheroes2::GameMode Game::Load( const std::string & fn )
 {
     DEBUG_LOG( DBG_GAME, DBG_INFO, fn );
 
+    autoSaveWriter.wait();
+
     StreamFile fs;
     fs.setbigendian( true );
 
@@ -264,6 +362,8 @@ bool Game::LoadSAV2FileInfo( const std::string & fn, Maps::FileInfo & finfo )
 {
     DEBUG_LOG( DBG_GAME, DBG_INFO, fn );
 
+    autoSaveWriter.wait();
+
     StreamFile fs;
     fs.setbigendian( true );
 
@@ -83,6 +83,9 @@ void Game::mainGameLoop( bool isFirstGameRun )
     fheroes2::GameMode result = fheroes2::GameMode::MAIN_MENU;
 
     while ( result != fheroes2::GameMode::QUIT_GAME ) {
+        // Screens of the previous game mode are closed, so images which are not used for a while can be freed
+        fheroes2::AGG::trimCache();
+
         switch ( result ) {
         case fheroes2::GameMode::MAIN_MENU:
             result = Game::MainMenu( isFirstGameRun );
@@ -179,6 +182,10 @@ fheroes2::GameMode Game::MainMenu( bool isFirstGameRun )
 
     // image background
     fheroes2::drawMainMenuScreen();
+
+    // Start decoding of the images of the screens which are usually opened from the main menu
+    fheroes2::AGG::preloadICNs( { ICN::REDBACK, ICN::BTNNEWGM, ICN::BTNMP, ICN::BTNDCCFG } );
+
     if ( isFirstGameRun ) {
         fheroes2::selectLanguage( fheroes2::getSupportedLanguages(), fheroes2::getLanguageFromAbbreviation( conf.getGameLanguage() ) );
 
@@ -1116,7 +1116,7 @@ fheroes2::GameMode Interface::Basic::HumanTurn( bool isload )
         if ( Game::validateAnimationDelay( Game::MAPS_DELAY ) ) {
             u32 & frame = Game::MapsAnimationFrame();
             ++frame;
-            gameArea.SetRedraw();
+            gameArea.SetAnimatedTilesRedraw();
         }
 
         // check that the kingdom is not vanquished yet (has at least one hero or castle)
@@ -1124,7 +1124,13 @@ fheroes2::GameMode Interface::Basic::HumanTurn( bool isload )
             res = fheroes2::GameMode::END_TURN;
         }
 
-        if ( NeedRedraw() ) {
+        if ( GetRedrawMask() == REDRAW_GAMEAREA_TILES ) {
+            // Only animated objects have been changed, render just the part of the screen they occupy
+            const fheroes2::Rect changedArea = gameArea.RedrawTiles( display, LEVEL_ALL );
+            redraw = 0;
+            display.render( changedArea );
+        }
+        else if ( NeedRedraw() ) {
             Redraw();
             display.render();
         }
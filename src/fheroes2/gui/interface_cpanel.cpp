@@ -52,8 +52,8 @@ void Interface::ControlPanel::ResetTheme( void )
 {
     const int icn = Settings::Get().ExtGameEvilInterface() ? ICN::ADVEBTNS : ICN::ADVBTNS;
 
-    _buttons.reset( new Buttons( fheroes2::AGG::GetICN( icn, 4 ), fheroes2::AGG::GetICN( icn, 0 ), fheroes2::AGG::GetICN( icn, 12 ), fheroes2::AGG::GetICN( icn, 10 ),
-                                 fheroes2::AGG::GetICN( icn, 8 ) ) );
+    _buttons.reset( new Buttons( icn, fheroes2::AGG::GetICN( icn, 4 ), fheroes2::AGG::GetICN( icn, 0 ), fheroes2::AGG::GetICN( icn, 12 ),
+                                 fheroes2::AGG::GetICN( icn, 10 ), fheroes2::AGG::GetICN( icn, 8 ) ) );
 }
 
 const fheroes2::Rect & Interface::ControlPanel::GetArea( void ) const
@@ -24,6 +24,7 @@
 #ifndef H2INTERFACE_CPANEL_H
 #define H2INTERFACE_CPANEL_H
 
+#include "agg_image.h"
 #include "game_mode.h"
 #include "math_base.h"
 
@@ -53,18 +54,20 @@ namespace Interface
     private:
         Basic & interface;
 
-        // We do not want to make a copy of images but to store just references to them.
+        // We do not want to make a copy of images but to store just references to them. The images are pinned to keep these references valid.
         struct Buttons
         {
-            Buttons( const fheroes2::Sprite & radar_, const fheroes2::Sprite & icon_, const fheroes2::Sprite & button_, const fheroes2::Sprite & stats_,
-                     const fheroes2::Sprite & quit_ )
-                : radar( radar_ )
+            Buttons( const int icnId, const fheroes2::Sprite & radar_, const fheroes2::Sprite & icon_, const fheroes2::Sprite & button_,
+                     const fheroes2::Sprite & stats_, const fheroes2::Sprite & quit_ )
+                : pin( icnId )
+                , radar( radar_ )
                 , icon( icon_ )
                 , button( button_ )
                 , stats( stats_ )
                 , quit( quit_ )
             {}
 
+            const fheroes2::AGG::ICNPin pin;
             const fheroes2::Sprite & radar;
             const fheroes2::Sprite & icon;
             const fheroes2::Sprite & button;
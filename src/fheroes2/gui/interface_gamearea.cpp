@@ -37,8 +37,133 @@
 #include "tools.h"
 #include "world.h"
 
+#include <algorithm>
 #include <cassert>
 
+namespace
+{
+    // Size of the side of a square block of tiles which are marked for redraw together
+    const int32_t redrawBlockSize = 4;
+
+    // Objects on the tiles this far from an area which is being redrawn can overlap it
+    const int32_t redrawAreaMargin = 2;
+
+    // Size of the side of a square chunk of tiles whose ground images are combined into one image
+    const int32_t groundChunkSize = 8;
+
+    // Ground of the tiles never changes during the game so it is drawn by chunks of tiles instead of drawing every tile separately.
+    // Chunks are built when they become visible for the first time. The least recently used chunks are released to limit memory usage.
+    class GroundChunkCache
+    {
+    public:
+        // Returns the ground image of the given chunk. The image is rebuilt if the ground of any tile in the chunk has been changed
+        // since it was built, for example, if another map has been loaded.
+        const fheroes2::Image & getChunk( const int32_t chunkX, const int32_t chunkY, const size_t maxChunkCount )
+        {
+            const int32_t chunksPerRow = ( world.w() + groundChunkSize - 1 ) / groundChunkSize;
+            const int32_t chunksPerColumn = ( world.h() + groundChunkSize - 1 ) / groundChunkSize;
+
+            if ( chunksPerRow != _chunksPerRow || static_cast<size_t>( chunksPerRow * chunksPerColumn ) != _chunks.size() ) {
+                _chunks.clear();
+                _chunks.resize( static_cast<size_t>( chunksPerRow * chunksPerColumn ) );
+                _chunksPerRow = chunksPerRow;
+                _builtChunkCount = 0;
+            }
+
+            assert( chunkX >= 0 && chunkX < chunksPerRow && chunkY >= 0 && chunkY < chunksPerColumn );
+
+            Chunk & chunk = _chunks[chunkY * chunksPerRow + chunkX];
+            chunk.lastUse = ++_useCounter;
+
+            const fheroes2::Rect tileArea( chunkX * groundChunkSize, chunkY * groundChunkSize, std::min( groundChunkSize, world.w() - chunkX * groundChunkSize ),
+                                           std::min( groundChunkSize, world.h() - chunkY * groundChunkSize ) );
+
+            if ( chunk.image.empty() ) {
+                if ( _builtChunkCount >= maxChunkCount ) {
+                    releaseLeastRecentlyUsedChunk();
+                }
+                else {
+                    ++_builtChunkCount;
+                }
+
+                buildChunk( chunk, tileArea );
+            }
+            else if ( isGroundChanged( chunk, tileArea ) ) {
+                buildChunk( chunk, tileArea );
+            }
+
+            return chunk.image;
+        }
+
+    private:
+        struct Chunk
+        {
+            fheroes2::Image image;
+            std::vector<uint16_t> groundIds;
+            uint32_t lastUse = 0;
+        };
+
+        static uint16_t getGroundId( const Maps::Tiles & tile )
+        {
+            return static_cast<uint16_t>( tile.TileSpriteIndex() | ( tile.TileSpriteShape() << 14 ) );
+        }
+
+        static void buildChunk( Chunk & chunk, const fheroes2::Rect & tileArea )
+        {
+            chunk.image.resize( tileArea.width * TILEWIDTH, tileArea.height * TILEWIDTH );
+            chunk.groundIds.resize( static_cast<size_t>( tileArea.width * tileArea.height ) );
+
+            std::vector<uint16_t>::iterator groundId = chunk.groundIds.begin();
+
+            for ( int32_t y = 0; y < tileArea.height; ++y ) {
+                for ( int32_t x = 0; x < tileArea.width; ++x, ++groundId ) {
+                    const Maps::Tiles & tile = world.GetTiles( tileArea.x + x, tileArea.y + y );
+                    fheroes2::Copy( tile.GetTileSurface(), 0, 0, chunk.image, x * TILEWIDTH, y * TILEWIDTH, TILEWIDTH, TILEWIDTH );
+                    *groundId = getGroundId( tile );
+                }
+            }
+        }
+
+        static bool isGroundChanged( const Chunk & chunk, const fheroes2::Rect & tileArea )
+        {
+            std::vector<uint16_t>::const_iterator groundId = chunk.groundIds.begin();
+
+            for ( int32_t y = 0; y < tileArea.height; ++y ) {
+                for ( int32_t x = 0; x < tileArea.width; ++x, ++groundId ) {
+                    if ( *groundId != getGroundId( world.GetTiles( tileArea.x + x, tileArea.y + y ) ) ) {
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        void releaseLeastRecentlyUsedChunk()
+        {
+            Chunk * oldestChunk = nullptr;
+
+            for ( Chunk & chunk : _chunks ) {
+                if ( !chunk.image.empty() && ( oldestChunk == nullptr || chunk.lastUse < oldestChunk->lastUse ) ) {
+                    oldestChunk = &chunk;
+                }
+            }
+
+            if ( oldestChunk != nullptr ) {
+                oldestChunk->image.clear();
+                oldestChunk->groundIds.clear();
+            }
+        }
+
+        std::vector<Chunk> _chunks;
+        int32_t _chunksPerRow = 0;
+        size_t _builtChunkCount = 0;
+        uint32_t _useCounter = 0;
+    };
+
+    GroundChunkCache groundChunkCache;
+}
+
 Interface::GameArea::GameArea( Basic & basic )
     : interface( basic )
     , _minLeftOffset( 0 )
@@ -62,7 +187,7 @@ void Interface::GameArea::ShiftCenter( const fheroes2::Point & offset )
 
 fheroes2::Rect Interface::GameArea::RectFixed( fheroes2::Point & dst, int rw, int rh ) const
 {
-    std::pair<fheroes2::Rect, fheroes2::Point> res = Fixed4Blit( fheroes2::Rect( dst.x, dst.y, rw, rh ), GetROI() );
+    std::pair<fheroes2::Rect, fheroes2::Point> res = Fixed4Blit( fheroes2::Rect( dst.x, dst.y, rw, rh ), _clipROI );
     dst = res.second;
     return res.first;
 }
@@ -78,6 +203,7 @@ void Interface::GameArea::generate( const fheroes2::Size & screenSize, const boo
 void Interface::GameArea::SetAreaPosition( int32_t x, int32_t y, int32_t w, int32_t h )
 {
     _windowROI = fheroes2::Rect( x, y, w, h );
+    _clipROI = _windowROI;
     const fheroes2::Size worldSize( world.w() * TILEWIDTH, world.h() * TILEWIDTH );
 
     if ( worldSize.width > w ) {
@@ -118,11 +244,10 @@ void Interface::GameArea::BlitOnTile( fheroes2::Image & dst, const fheroes2::Ima
     const int32_t height = src.height();
 
     // In most of cases objects locate within window ROI so we don't need to calculate truncated ROI
-    if ( dstpt.x >= _windowROI.x && dstpt.y >= _windowROI.y && dstpt.x + width <= _windowROI.x + _windowROI.width
-         && dstpt.y + height <= _windowROI.y + _windowROI.height ) {
+    if ( dstpt.x >= _clipROI.x && dstpt.y >= _clipROI.y && dstpt.x + width <= _clipROI.x + _clipROI.width && dstpt.y + height <= _clipROI.y + _clipROI.height ) {
         fheroes2::AlphaBlit( src, 0, 0, dst, dstpt.x, dstpt.y, width, height, alpha, flip );
     }
-    else if ( _windowROI & fheroes2::Rect( dstpt.x, dstpt.y, width, height ) ) {
+    else if ( _clipROI & fheroes2::Rect( dstpt.x, dstpt.y, width, height ) ) {
         const fheroes2::Rect & fixedRect = RectFixed( dstpt, width, height );
         fheroes2::AlphaBlit( src, fixedRect.x, fixedRect.y, dst, dstpt.x, dstpt.y, fixedRect.width, fixedRect.height, alpha, flip );
     }
@@ -136,11 +261,10 @@ void Interface::GameArea::DrawTile( fheroes2::Image & dst, const fheroes2::Image
     const int32_t height = src.height();
 
     // In most of cases objects locate within window ROI so we don't need to calculate truncated ROI
-    if ( dstpt.x >= _windowROI.x && dstpt.y >= _windowROI.y && dstpt.x + width <= _windowROI.x + _windowROI.width
-         && dstpt.y + height <= _windowROI.y + _windowROI.height ) {
+    if ( dstpt.x >= _clipROI.x && dstpt.y >= _clipROI.y && dstpt.x + width <= _clipROI.x + _clipROI.width && dstpt.y + height <= _clipROI.y + _clipROI.height ) {
         fheroes2::Copy( src, 0, 0, dst, dstpt.x, dstpt.y, width, height );
     }
-    else if ( _windowROI & fheroes2::Rect( dstpt.x, dstpt.y, width, height ) ) {
+    else if ( _clipROI & fheroes2::Rect( dstpt.x, dstpt.y, width, height ) ) {
         const fheroes2::Rect & fixedRect = RectFixed( dstpt, width, height );
         fheroes2::Copy( src, fixedRect.x, fixedRect.y, dst, dstpt.x, dstpt.y, fixedRect.width, fixedRect.height );
     }
@@ -148,32 +272,100 @@ void Interface::GameArea::DrawTile( fheroes2::Image & dst, const fheroes2::Image
 
 void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzleDraw ) const
 {
-    const fheroes2::Rect & tileROI = GetVisibleTileROI();
+    _redrawTileArea( dst, flag, isPuzzleDraw, GetVisibleTileROI() );
+}
+
+fheroes2::Rect Interface::GameArea::RedrawTiles( fheroes2::Image & dst, int flag )
+{
+    if ( _tilesToRedraw.empty() ) {
+        return {};
+    }
+
+    const fheroes2::Rect visibleTileROI = GetVisibleTileROI() ^ fheroes2::Rect( 0, 0, world.w(), world.h() );
+    const int32_t blocksPerRow = ( world.w() + redrawBlockSize - 1 ) / redrawBlockSize;
+    const int32_t blocksPerColumn = static_cast<int32_t>( _tilesToRedraw.size() ) / blocksPerRow;
+
+    // Join the marked blocks of every row into horizontal strips of tiles
+    std::vector<fheroes2::Rect> tileAreas;
+    int64_t redrawnTileCount = 0;
+
+    for ( int32_t blockY = 0; blockY < blocksPerColumn; ++blockY ) {
+        const uint8_t * blockRow = _tilesToRedraw.data() + blockY * blocksPerRow;
+
+        for ( int32_t blockX = 0; blockX < blocksPerRow; ++blockX ) {
+            if ( blockRow[blockX] == 0 ) {
+                continue;
+            }
+
+            const int32_t firstBlockX = blockX;
+            while ( blockX + 1 < blocksPerRow && blockRow[blockX + 1] != 0 ) {
+                ++blockX;
+            }
+
+            const fheroes2::Rect strip( firstBlockX * redrawBlockSize, blockY * redrawBlockSize, ( blockX - firstBlockX + 1 ) * redrawBlockSize, redrawBlockSize );
+            if ( !( visibleTileROI & strip ) ) {
+                continue;
+            }
+
+            const fheroes2::Rect tileArea = visibleTileROI ^ strip;
+            if ( tileArea.width > 0 && tileArea.height > 0 ) {
+                tileAreas.emplace_back( tileArea );
+                redrawnTileCount += tileArea.width * tileArea.height;
+            }
+        }
+    }
+
+    ResetTileRedraw();
+
+    // Redrawing of the areas around the strips costs more than redrawing of the same number of tiles at once
+    if ( redrawnTileCount * 2 > static_cast<int64_t>( visibleTileROI.width ) * visibleTileROI.height ) {
+        Redraw( dst, flag );
+        return _windowROI;
+    }
 
+    fheroes2::Rect changedArea;
+
+    for ( const fheroes2::Rect & tileArea : tileAreas ) {
+        const fheroes2::Point pos = GetRelativeTilePosition( { tileArea.x, tileArea.y } );
+        const fheroes2::Rect pixelArea( pos.x, pos.y, tileArea.width * TILEWIDTH, tileArea.height * TILEWIDTH );
+        if ( !( _windowROI & pixelArea ) ) {
+            continue;
+        }
+
+        _clipROI = _windowROI ^ pixelArea;
+        if ( _clipROI.width <= 0 || _clipROI.height <= 0 ) {
+            continue;
+        }
+
+        const fheroes2::Rect tileROI( tileArea.x - redrawAreaMargin, tileArea.y - redrawAreaMargin, tileArea.width + 2 * redrawAreaMargin,
+                                      tileArea.height + 2 * redrawAreaMargin );
+        _redrawTileArea( dst, flag, false, tileROI );
+
+        changedArea = ( changedArea.width > 0 ) ? fheroes2::getBoundaryRect( changedArea, _clipROI ) : _clipROI;
+    }
+
+    _clipROI = _windowROI;
+
+    return changedArea;
+}
+
+void Interface::GameArea::_redrawTileArea( fheroes2::Image & dst, int flag, bool isPuzzleDraw, const fheroes2::Rect & tileROI ) const
+{
     int32_t minX = tileROI.x;
     int32_t minY = tileROI.y;
     int32_t maxX = tileROI.x + tileROI.width;
     int32_t maxY = tileROI.y + tileROI.height;
 
-    // Ground level. Also find range of X and Y tile positions.
+    // Ground level outside of the world.
     for ( int32_t y = 0; y < tileROI.height; ++y ) {
         fheroes2::Point offset( tileROI.x, tileROI.y + y );
+        const bool isRowOutsideWorld = offset.y < 0 || offset.y >= world.h();
 
-        if ( offset.y < 0 || offset.y >= world.h() ) {
-            for ( ; offset.x < maxX; ++offset.x ) {
+        for ( ; offset.x < maxX; ++offset.x ) {
+            if ( isRowOutsideWorld || offset.x < 0 || offset.x >= world.w() ) {
                 Maps::Tiles::RedrawEmptyTile( dst, offset, tileROI, *this );
             }
         }
-        else {
-            for ( ; offset.x < maxX; ++offset.x ) {
-                if ( offset.x < 0 || offset.x >= world.w() ) {
-                    Maps::Tiles::RedrawEmptyTile( dst, offset, tileROI, *this );
-                }
-                else {
-                    world.GetTiles( offset.x, offset.y ).RedrawTile( dst, tileROI, *this );
-                }
-            }
-        }
     }
 
     if ( minX < 0 )
@@ -191,6 +383,22 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
         return;
     }
 
+    // Ground level of the world. Keep enough chunks in cache to cover the visible area twice so scrolling back and forth doesn't rebuild them.
+    {
+        const int32_t minChunkX = minX / groundChunkSize;
+        const int32_t minChunkY = minY / groundChunkSize;
+        const int32_t maxChunkX = ( maxX - 1 ) / groundChunkSize;
+        const int32_t maxChunkY = ( maxY - 1 ) / groundChunkSize;
+        const size_t maxChunkCount
+            = 2 * static_cast<size_t>( ( _visibleTileCount.width / groundChunkSize + 2 ) * ( _visibleTileCount.height / groundChunkSize + 2 ) );
+
+        for ( int32_t chunkY = minChunkY; chunkY <= maxChunkY; ++chunkY ) {
+            for ( int32_t chunkX = minChunkX; chunkX <= maxChunkX; ++chunkX ) {
+                DrawTile( dst, groundChunkCache.getChunk( chunkX, chunkY, maxChunkCount ), { chunkX * groundChunkSize, chunkY * groundChunkSize } );
+            }
+        }
+    }
+
     std::vector<const Maps::Tiles *> drawList;
     std::vector<const Maps::Tiles *> monsterList;
     std::vector<const Maps::Tiles *> topList;
@@ -542,6 +750,75 @@ void Interface::GameArea::SetRedraw( void ) const
     interface.SetRedraw( REDRAW_GAMEAREA );
 }
 
+void Interface::GameArea::SetTileRedraw( const int32_t tileIndex )
+{
+    if ( !Maps::isValidAbsIndex( tileIndex ) ) {
+        return;
+    }
+
+    // Panels of the hidden interface are drawn over Game Area so they have to be redrawn as well
+    if ( Settings::Get().ExtGameHideInterface() ) {
+        SetRedraw();
+        return;
+    }
+
+    const int32_t blocksPerRow = ( world.w() + redrawBlockSize - 1 ) / redrawBlockSize;
+    const int32_t blocksPerColumn = ( world.h() + redrawBlockSize - 1 ) / redrawBlockSize;
+    _tilesToRedraw.resize( static_cast<size_t>( blocksPerRow * blocksPerColumn ), 0 );
+
+    // Heroes and monsters are taller than a tile, the rest of sprites overlap only the adjacent tiles
+    const fheroes2::Point & mp = Maps::GetPoint( tileIndex );
+    const int32_t minBlockX = std::max( mp.x - 1, 0 ) / redrawBlockSize;
+    const int32_t maxBlockX = std::min( mp.x + 1, world.w() - 1 ) / redrawBlockSize;
+    const int32_t minBlockY = std::max( mp.y - 2, 0 ) / redrawBlockSize;
+    const int32_t maxBlockY = std::min( mp.y + 1, world.h() - 1 ) / redrawBlockSize;
+
+    for ( int32_t blockY = minBlockY; blockY <= maxBlockY; ++blockY ) {
+        for ( int32_t blockX = minBlockX; blockX <= maxBlockX; ++blockX ) {
+            _tilesToRedraw[blockY * blocksPerRow + blockX] = 1;
+        }
+    }
+
+    interface.SetRedraw( REDRAW_GAMEAREA_TILES );
+}
+
+void Interface::GameArea::SetAnimatedTilesRedraw()
+{
+    if ( Settings::Get().ExtGameHideInterface() ) {
+        SetRedraw();
+        return;
+    }
+
+    // Sprites of the objects just outside of the visible area can overlap it
+    const fheroes2::Rect visibleTileROI = GetVisibleTileROI();
+    const int32_t minX = std::max( visibleTileROI.x - redrawAreaMargin, 0 );
+    const int32_t minY = std::max( visibleTileROI.y - redrawAreaMargin, 0 );
+    const int32_t maxX = std::min( visibleTileROI.x + visibleTileROI.width + redrawAreaMargin, world.w() );
+    const int32_t maxY = std::min( visibleTileROI.y + visibleTileROI.height + redrawAreaMargin, world.h() );
+
+#ifdef WITH_DEBUG
+    const bool isFogDrawn = !IS_DEVEL();
+#else
+    const bool isFogDrawn = true;
+#endif
+    const int friendColors = Players::FriendColors();
+
+    for ( int32_t y = minY; y < maxY; ++y ) {
+        for ( int32_t x = minX; x < maxX; ++x ) {
+            const Maps::Tiles & tile = world.GetTiles( x, y );
+
+            // Objects of the tiles covered by fog are not drawn at all
+            if ( isFogDrawn && tile.isFogAllAround( friendColors ) ) {
+                continue;
+            }
+
+            if ( tile.isAnimated() ) {
+                SetTileRedraw( tile.GetIndex() );
+            }
+        }
+    }
+}
+
 /* scroll area to center point maps */
 void Interface::GameArea::SetCenter( const fheroes2::Point & pt )
 {
@@ -24,6 +24,8 @@
 #ifndef H2INTERFACE_GAMEAREA_H
 #define H2INTERFACE_GAMEAREA_H
 
+#include <vector>
+
 #include "image.h"
 #include "timing.h"
 
@@ -86,8 +88,24 @@ namespace Interface
 
         void SetRedraw( void ) const;
 
+        // Marks the area around the given tile to be redrawn by RedrawTiles(). Sprites of objects can exceed the borders of their tiles,
+        // so the neighbouring tiles are marked as well.
+        void SetTileRedraw( const int32_t tileIndex );
+
+        // Marks the visible tiles which have animated objects to be redrawn by RedrawTiles()
+        void SetAnimatedTilesRedraw();
+
+        void ResetTileRedraw()
+        {
+            _tilesToRedraw.clear();
+        }
+
         void Redraw( fheroes2::Image & dst, int flag, bool isPuzzleDraw = false ) const;
 
+        // Redraws only the areas marked by SetTileRedraw() and returns the rectangle in pixels which covers all changes.
+        // If most of the visible area has been marked then the whole Game Area is redrawn.
+        fheroes2::Rect RedrawTiles( fheroes2::Image & dst, int flag );
+
         void BlitOnTile( fheroes2::Image & dst, const fheroes2::Image & src, int32_t ox, int32_t oy, const fheroes2::Point & mp, bool flip = false,
                          uint8_t alpha = 255 ) const;
         void BlitOnTile( fheroes2::Image & dst, const fheroes2::Sprite & src, const fheroes2::Point & mp ) const;
@@ -122,6 +140,7 @@ namespace Interface
         Basic & interface;
 
         fheroes2::Rect _windowROI; // visible to draw area of World Map in pixels
+        mutable fheroes2::Rect _clipROI; // area in pixels to which drawing of tiles is limited, the same as _windowROI except for partial redraws
         fheroes2::Point _topLeftTileOffset; // offset of tiles to be drawn (from here we can find any tile ID)
 
         // boundaries for World Map
@@ -138,6 +157,11 @@ namespace Interface
 
         fheroes2::Time scrollTime;
 
+        // Tiles are marked for redraw by square blocks, one flag per block. The array is empty if no tiles are marked.
+        std::vector<uint8_t> _tilesToRedraw;
+
+        void _redrawTileArea( fheroes2::Image & dst, int flag, bool isPuzzleDraw, const fheroes2::Rect & tileROI ) const;
+
         fheroes2::Point _middlePoint() const; // returns middle point of window ROI
         fheroes2::Point _getStartTileId() const;
         void _setCenterToTile( const fheroes2::Point & tile ); // set center to the middle of tile (input is tile ID)
@@ -125,10 +125,159 @@ uint8_t GetPaletteIndexFromColor( int color )
     return COLOR_WHITE;
 }
 
+namespace
+{
+    // Placement of the tiles on the radar: only every step-th tile is drawn as a square of chunkSize pixels
+    struct RadarLayout
+    {
+        int32_t stepX;
+        int32_t stepY;
+        int32_t areaWidth;
+        int32_t areaHeight;
+        int32_t chunkSize;
+    };
+
+    RadarLayout getRadarLayout( const fheroes2::Rect & rect, const fheroes2::Point & offset )
+    {
+        const int32_t worldWidth = world.w();
+        const int32_t worldHeight = world.h();
+
+        RadarLayout layout;
+        layout.areaWidth = rect.width - 2 * offset.x;
+        layout.areaHeight = rect.height - 2 * offset.y;
+        layout.stepX = std::max( worldWidth / rect.width, 1 );
+        layout.stepY = std::max( worldHeight / rect.height, 1 );
+
+        if ( worldWidth >= worldHeight )
+            layout.chunkSize = GetChunkSize( layout.areaWidth, worldWidth );
+        else
+            layout.chunkSize = GetChunkSize( layout.areaHeight, worldHeight );
+
+        return layout;
+    }
+
+    // Returns false if the terrain of the tile is shown on the radar, otherwise the color of the tile is written to fillColor
+    bool getTileRadarColor( const Maps::Tiles & tile, const int color, const ViewWorldMode flags, uint8_t & fillColor )
+    {
+        const bool revealAll = flags == ViewWorldMode::ViewAll;
+        const bool revealMines = revealAll || ( flags == ViewWorldMode::ViewMines );
+        const bool revealHeroes = revealAll || ( flags == ViewWorldMode::ViewHeroes );
+        const bool revealTowns = revealAll || ( flags == ViewWorldMode::ViewTowns );
+        const bool revealArtifacts = revealAll || ( flags == ViewWorldMode::ViewArtifacts );
+        const bool revealResources = revealAll || ( flags == ViewWorldMode::ViewResources );
+        const bool revealOnlyVisible = revealAll || ( flags == ViewWorldMode::OnlyVisible );
+
+#ifdef WITH_DEBUG
+        const bool visibleTile = revealAll || IS_DEVEL() || !tile.isFog( color );
+#else
+        const bool visibleTile = revealAll || !tile.isFog( color );
+#endif
+        fillColor = 0;
+
+        switch ( tile.GetObject( revealOnlyVisible || revealHeroes ) ) {
+        case MP2::OBJ_HEROES: {
+            if ( visibleTile || revealHeroes ) {
+                const Heroes * hero = world.GetHeroes( tile.GetCenter() );
+                if ( hero )
+                    fillColor = GetPaletteIndexFromColor( hero->GetColor() );
+            }
+            break;
+        }
+        case MP2::OBJ_CASTLE:
+        case MP2::OBJN_CASTLE: {
+            if ( visibleTile || revealTowns ) {
+                const Castle * castle = world.getCastle( tile.GetCenter() );
+                if ( castle )
+                    fillColor = GetPaletteIndexFromColor( castle->GetColor() );
+            }
+            break;
+        }
+        case MP2::OBJ_DRAGONCITY:
+        case MP2::OBJ_LIGHTHOUSE:
+        case MP2::OBJ_ALCHEMYLAB:
+        case MP2::OBJ_MINES:
+        case MP2::OBJ_SAWMILL:
+            if ( visibleTile || revealMines ) {
+                fillColor = GetPaletteIndexFromColor( tile.QuantityColor() );
+            }
+            break;
+        case MP2::OBJN_DRAGONCITY:
+        case MP2::OBJN_LIGHTHOUSE:
+        case MP2::OBJN_ALCHEMYLAB:
+        case MP2::OBJN_MINES:
+        case MP2::OBJN_SAWMILL:
+            if ( visibleTile || revealMines ) {
+                const int32_t mainTileIndex = Maps::Tiles::getIndexOfMainTile( tile );
+                if ( mainTileIndex >= 0 ) {
+                    fillColor = GetPaletteIndexFromColor( world.GetTiles( mainTileIndex ).QuantityColor() );
+                }
+            }
+            break;
+        case MP2::OBJ_ARTIFACT:
+            if ( visibleTile || revealArtifacts ) {
+                fillColor = COLOR_GRAY;
+            }
+            break;
+        case MP2::OBJ_RESOURCE:
+            if ( visibleTile || revealResources ) {
+                fillColor = COLOR_GRAY;
+            }
+            break;
+        default:
+            if ( visibleTile ) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Draws the tiles from the given area of the world which are not shown by their terrain. Output is limited by the clip area.
+    void drawRadarObjects( fheroes2::Image & output, const fheroes2::Point & offset, const fheroes2::Rect & clip, const RadarLayout & layout,
+                           const fheroes2::Rect & tileROI, const int color, const ViewWorldMode flags )
+    {
+        const int32_t worldWidth = world.w();
+        const int32_t worldHeight = world.h();
+
+        // Only the tiles in every step-th row and column are drawn
+        const int32_t minX = ( ( std::max( tileROI.x, 0 ) + layout.stepX - 1 ) / layout.stepX ) * layout.stepX;
+        const int32_t minY = ( ( std::max( tileROI.y, 0 ) + layout.stepY - 1 ) / layout.stepY ) * layout.stepY;
+        const int32_t maxX = std::min( tileROI.x + tileROI.width, worldWidth );
+        const int32_t maxY = std::min( tileROI.y + tileROI.height, worldHeight );
+
+        for ( int32_t y = minY; y < maxY; y += layout.stepY ) {
+            const int dsty = offset.y + ( y * layout.areaHeight ) / worldHeight; // calculate once per row
+
+            int tileIndex = y * worldWidth + minX;
+            for ( int32_t x = minX; x < maxX; x += layout.stepX, tileIndex += layout.stepX ) {
+                uint8_t fillColor = 0;
+                if ( !getTileRadarColor( world.GetTiles( tileIndex ), color, flags, fillColor ) ) {
+                    continue;
+                }
+
+                const int dstx = offset.x + ( x * layout.areaWidth ) / worldWidth;
+
+                const fheroes2::Rect fillArea = clip ^ fheroes2::Rect( dstx, dsty, layout.chunkSize, layout.chunkSize );
+                if ( fillArea.width <= 0 || fillArea.height <= 0 ) {
+                    continue;
+                }
+
+                if ( fillArea.width > 1 || fillArea.height > 1 ) {
+                    fheroes2::Fill( output, fillArea.x, fillArea.y, fillArea.width, fillArea.height, fillColor );
+                }
+                else {
+                    fheroes2::SetPixel( output, fillArea.x, fillArea.y, fillColor );
+                }
+            }
+        }
+    }
+}
+
 Interface::Radar::Radar( Basic & basic )
     : BorderWindow( { 0, 0, RADARWIDTH, RADARWIDTH } )
     , radarType( RadarType::WorldMap )
     , interface( basic )
+    , _radarImageColors( 0 )
     , hide( true )
 {}
 
@@ -137,6 +286,7 @@ Interface::Radar::Radar( const Radar & radar )
     , radarType( radar.radarType )
     , interface( radar.interface )
     , spriteArea( radar.spriteArea )
+    , _radarImageColors( 0 )
     , hide( radar.hide )
 {}
 
@@ -209,6 +359,8 @@ void Interface::Radar::Generate( void )
         fheroes2::Resize( spriteArea, resized );
         spriteArea = std::move( resized );
     }
+
+    _radarImage.clear();
 }
 
 void Interface::Radar::SetHide( bool f )
@@ -238,8 +390,8 @@ void Interface::Radar::Redraw()
         }
         else {
             cursorArea.hide();
-            fheroes2::Blit( spriteArea, display, rect.x + offset.x, rect.y + offset.y );
-            RedrawObjects( Players::FriendColors(), ViewWorldMode::OnlyVisible );
+            updateRadarImage();
+            fheroes2::Blit( _radarImage, display, rect.x + offset.x, rect.y + offset.y );
             RedrawCursor();
         }
     }
@@ -258,118 +410,59 @@ void Interface::Radar::RedrawForViewWorld( const ViewWorld::ZoomROIs & roi, cons
 
 void Interface::Radar::RedrawObjects( int color, ViewWorldMode flags ) const
 {
-    const bool revealAll = flags == ViewWorldMode::ViewAll;
-    const bool revealMines = revealAll || ( flags == ViewWorldMode::ViewMines );
-    const bool revealHeroes = revealAll || ( flags == ViewWorldMode::ViewHeroes );
-    const bool revealTowns = revealAll || ( flags == ViewWorldMode::ViewTowns );
-    const bool revealArtifacts = revealAll || ( flags == ViewWorldMode::ViewArtifacts );
-    const bool revealResources = revealAll || ( flags == ViewWorldMode::ViewResources );
-    const bool revealOnlyVisible = revealAll || ( flags == ViewWorldMode::OnlyVisible );
-
     const fheroes2::Rect & rect = GetArea();
 
     fheroes2::Display & display = fheroes2::Display::instance();
 
-    const int32_t worldWidth = world.w();
-    const int32_t worldHeight = world.h();
-    const int areaw = rect.width - 2 * offset.x;
-    const int areah = rect.height - 2 * offset.y;
-
-    int stepx = worldWidth / rect.width;
-    int stepy = worldHeight / rect.height;
+    drawRadarObjects( display, { rect.x + offset.x, rect.y + offset.y }, { 0, 0, display.width(), display.height() }, getRadarLayout( rect, offset ),
+                      { 0, 0, world.w(), world.h() }, color, flags );
+}
 
-    if ( 0 == stepx )
-        stepx = 1;
-    if ( 0 == stepy )
-        stepy = 1;
+void Interface::Radar::updateRadarImage()
+{
+    const int friendColors = Players::FriendColors();
+    const RadarLayout layout = getRadarLayout( GetArea(), offset );
+    const fheroes2::Rect imageROI( 0, 0, spriteArea.width(), spriteArea.height() );
 
-    int sw = 0;
+    // The list of changed tiles has to be taken anyway, otherwise it would keep the changes which have been already drawn
+    const bool areChangesTracked = world.takeRadarChangedTiles( _changedTiles );
 
-    if ( worldWidth >= worldHeight )
-        sw = GetChunkSize( areaw, worldWidth );
-    else
-        sw = GetChunkSize( areah, worldHeight );
+    if ( !areChangesTracked || _radarImage.empty() || friendColors != _radarImageColors ) {
+        _radarImage = spriteArea;
+        _radarImageColors = friendColors;
 
-    const int32_t offsetX = rect.x + offset.x;
-    const int32_t offsetY = rect.y + offset.y;
+        drawRadarObjects( _radarImage, { 0, 0 }, imageROI, layout, { 0, 0, world.w(), world.h() }, friendColors, ViewWorldMode::OnlyVisible );
+        return;
+    }
 
-    for ( int32_t y = 0; y < worldHeight; y += stepy ) {
-        const int dsty = offsetY + ( y * areah ) / worldHeight; // calculate once per row
+    const int32_t worldWidth = world.w();
+    const int32_t worldHeight = world.h();
 
-        int tileIndex = y * worldWidth;
-        for ( int32_t x = 0; x < worldWidth; x += stepx, tileIndex += stepx ) {
-            const Maps::Tiles & tile = world.GetTiles( tileIndex );
-#ifdef WITH_DEBUG
-            const bool visibleTile = revealAll || IS_DEVEL() || !tile.isFog( color );
-#else
-            const bool visibleTile = revealAll || !tile.isFog( color );
-#endif
-            uint8_t fillColor = 0;
-
-            switch ( tile.GetObject( revealOnlyVisible || revealHeroes ) ) {
-            case MP2::OBJ_HEROES: {
-                if ( visibleTile || revealHeroes ) {
-                    const Heroes * hero = world.GetHeroes( tile.GetCenter() );
-                    if ( hero )
-                        fillColor = GetPaletteIndexFromColor( hero->GetColor() );
-                }
-                break;
-            }
-            case MP2::OBJ_CASTLE:
-            case MP2::OBJN_CASTLE: {
-                if ( visibleTile || revealTowns ) {
-                    const Castle * castle = world.getCastle( tile.GetCenter() );
-                    if ( castle )
-                        fillColor = GetPaletteIndexFromColor( castle->GetColor() );
-                }
-                break;
-            }
-            case MP2::OBJ_DRAGONCITY:
-            case MP2::OBJ_LIGHTHOUSE:
-            case MP2::OBJ_ALCHEMYLAB:
-            case MP2::OBJ_MINES:
-            case MP2::OBJ_SAWMILL:
-                if ( visibleTile || revealMines ) {
-                    fillColor = GetPaletteIndexFromColor( tile.QuantityColor() );
-                }
-                break;
-            case MP2::OBJN_DRAGONCITY:
-            case MP2::OBJN_LIGHTHOUSE:
-            case MP2::OBJN_ALCHEMYLAB:
-            case MP2::OBJN_MINES:
-            case MP2::OBJN_SAWMILL:
-                if ( visibleTile || revealMines ) {
-                    const int32_t mainTileIndex = Maps::Tiles::getIndexOfMainTile( tile );
-                    if ( mainTileIndex >= 0 ) {
-                        fillColor = GetPaletteIndexFromColor( world.GetTiles( mainTileIndex ).QuantityColor() );
-                    }
-                }
-                break;
-            case MP2::OBJ_ARTIFACT:
-                if ( visibleTile || revealArtifacts ) {
-                    fillColor = COLOR_GRAY;
-                }
-                break;
-            case MP2::OBJ_RESOURCE:
-                if ( visibleTile || revealResources ) {
-                    fillColor = COLOR_GRAY;
-                }
-                break;
-            default:
-                if ( visibleTile ) {
-                    continue;
-                }
-            }
+    for ( const int32_t tileIndex : _changedTiles ) {
+        if ( !Maps::isValidAbsIndex( tileIndex ) ) {
+            continue;
+        }
 
-            const int dstx = offsetX + ( x * areaw ) / worldWidth;
+        const fheroes2::Point mp = Maps::GetPoint( tileIndex );
+        if ( mp.x % layout.stepX != 0 || mp.y % layout.stepY != 0 ) {
+            // This tile is not shown on the radar
+            continue;
+        }
 
-            if ( sw > 1 ) {
-                fheroes2::Fill( display, dstx, dsty, sw, sw, fillColor );
-            }
-            else {
-                fheroes2::SetPixel( display, dstx, dsty, fillColor );
-            }
+        const fheroes2::Rect tileArea = imageROI
+                                        ^ fheroes2::Rect( ( mp.x * layout.areaWidth ) / worldWidth, ( mp.y * layout.areaHeight ) / worldHeight, layout.chunkSize,
+                                                          layout.chunkSize );
+        if ( tileArea.width <= 0 || tileArea.height <= 0 ) {
+            continue;
         }
+
+        // Squares of the neighbouring tiles can overlap the square of this tile so they have to be drawn again in the same order
+        fheroes2::Copy( spriteArea, tileArea.x, tileArea.y, _radarImage, tileArea.x, tileArea.y, tileArea.width, tileArea.height );
+
+        const int32_t marginX = layout.chunkSize * layout.stepX;
+        const int32_t marginY = layout.chunkSize * layout.stepY;
+        drawRadarObjects( _radarImage, { 0, 0 }, tileArea, layout, { mp.x - marginX, mp.y - marginY, 2 * marginX + 1, 2 * marginY + 1 }, friendColors,
+                          ViewWorldMode::OnlyVisible );
     }
 }
 
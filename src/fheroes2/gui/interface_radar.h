@@ -24,6 +24,8 @@
 #ifndef H2INTERFACE_RADAR_H
 #define H2INTERFACE_RADAR_H
 
+#include <vector>
+
 #include "interface_border.h"
 #include "ui_tool.h"
 #include "view_world.h"
@@ -65,6 +67,9 @@ namespace Interface
         void Generate( void );
         void RedrawObjects( int color, ViewWorldMode flags ) const;
 
+        // Brings the image of the world map radar up to date, redraws only the tiles which have been changed if possible
+        void updateRadarImage();
+
         void ChangeAreaSize( const fheroes2::Size & );
 
         RadarType radarType;
@@ -72,6 +77,12 @@ namespace Interface
 
         fheroes2::Image spriteArea;
         fheroes2::MovableSprite cursorArea;
+
+        // Terrain and objects visible for the colors _radarImageColors, only used for the world map radar
+        fheroes2::Image _radarImage;
+        int _radarImageColors;
+        std::vector<int32_t> _changedTiles;
+
         fheroes2::Point offset;
         bool hide;
     };
@@ -40,6 +40,7 @@ namespace fheroes2
     {
         _fileNameAndOffset.clear();
         _fileStream.close();
+        _mappedFile.close();
 
         if ( !_fileStream.open( path, "rb" ) ) {
             return false;
@@ -73,18 +74,30 @@ namespace fheroes2
             const uint32_t size = _fileStream.getLE32();
             std::string name;
             _fileStream >> name;
-            if ( size == 0 || offset + size > fileSize || name.empty() ) {
+            // The sum of the offset and the size may overflow, the check must not rely on it
+            if ( size == 0 || size > fileSize || offset > fileSize - size || name.empty() ) {
                 continue;
             }
 
             _fileNameAndOffset.emplace( std::move( name ), std::make_pair( offset, size ) );
         }
 
+        if ( _mappedFile.open( path ) && _mappedFile.size() != fileSize ) {
+            _mappedFile.close();
+        }
+
         return true;
     }
 
     std::vector<uint8_t> H2RReader::getFile( const std::string & fileName )
     {
+        if ( _mappedFile.isOpen() ) {
+            size_t size = 0;
+            const uint8_t * data = getData( fileName, size );
+
+            return data != nullptr ? std::vector<uint8_t>( data, data + size ) : std::vector<uint8_t>();
+        }
+
         const auto it = _fileNameAndOffset.find( fileName );
         if ( it == _fileNameAndOffset.end() ) {
             return std::vector<uint8_t>();
@@ -94,6 +107,24 @@ namespace fheroes2
         return _fileStream.getRaw( it->second.second );
     }
 
+    const uint8_t * H2RReader::getData( const std::string & fileName, size_t & size ) const
+    {
+        size = 0;
+
+        if ( !_mappedFile.isOpen() ) {
+            return nullptr;
+        }
+
+        const auto it = _fileNameAndOffset.find( fileName );
+        if ( it == _fileNameAndOffset.end() ) {
+            return nullptr;
+        }
+
+        // Offsets and sizes of all files have been verified while opening the archive
+        size = it->second.second;
+        return _mappedFile.data() + it->second.first;
+    }
+
     std::set<std::string> H2RReader::getAllFileNames() const
     {
         std::set<std::string> names;
@@ -171,25 +202,34 @@ namespace fheroes2
 
     bool readImageFromH2D( H2RReader & reader, const std::string & name, Sprite & image )
     {
-        const std::vector<uint8_t> & data = reader.getFile( name );
-        if ( data.size() < 4 + 4 + 4 + 4 + 1 ) {
+        // Use the data of the archive mapped into memory directly if possible
+        std::vector<uint8_t> buffer;
+        size_t dataSize = 0;
+        const uint8_t * data = reader.getData( name, dataSize );
+        if ( data == nullptr ) {
+            buffer = reader.getFile( name );
+            data = buffer.data();
+            dataSize = buffer.size();
+        }
+
+        if ( dataSize < 4 + 4 + 4 + 4 + 1 ) {
             // Empty or invalid image.
             return false;
         }
 
-        StreamBuf stream( data );
+        StreamBuf stream( data, dataSize );
         const int32_t width = static_cast<int32_t>( stream.getLE32() );
         const int32_t height = static_cast<int32_t>( stream.getLE32() );
         const int32_t x = static_cast<int32_t>( stream.getLE32() );
         const int32_t y = static_cast<int32_t>( stream.getLE32() );
-        if ( static_cast<size_t>( width * height * 2 + 4 + 4 + 4 + 4 ) != data.size() ) {
+        if ( static_cast<size_t>( width * height * 2 + 4 + 4 + 4 + 4 ) != dataSize ) {
             return false;
         }
 
         const size_t size = static_cast<size_t>( width * height );
         image.resize( width, height );
-        memcpy( image.image(), data.data() + 4 + 4 + 4 + 4, size );
-        memcpy( image.transform(), data.data() + 4 + 4 + 4 + 4 + size, size );
+        memcpy( image.image(), data + 4 + 4 + 4 + 4, size );
+        memcpy( image.transform(), data + 4 + 4 + 4 + 4 + size, size );
 
         image.setPosition( x, y );
 
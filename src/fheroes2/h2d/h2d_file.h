@@ -25,6 +25,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace fheroes2
@@ -41,14 +42,21 @@ namespace fheroes2
         // Returns non-empty vector if requested file exists.
         std::vector<uint8_t> getFile( const std::string & fileName );
 
+        // Returns a pointer to the contents of the file inside the archive mapped into memory, no data is copied. The pointer stays valid
+        // while the archive is open. Returns nullptr if there is no such file or the archive is not mapped into memory.
+        const uint8_t * getData( const std::string & fileName, size_t & size ) const;
+
         std::set<std::string> getAllFileNames() const;
 
     private:
         // Relationship between file name in non-capital letters and its offset from the start of the archive.
-        std::map<std::string, std::pair<uint32_t, uint32_t>> _fileNameAndOffset;
+        std::unordered_map<std::string, std::pair<uint32_t, uint32_t>> _fileNameAndOffset;
 
         // Stream for reading h2d file.
         StreamFile _fileStream;
+
+        // The whole h2d file if it can be mapped into memory, otherwise the stream is used.
+        MemoryMappedFile _mappedFile;
     };
 
     // This class is not designed to be performance optimized as it will be used very rarely and out of game running session.
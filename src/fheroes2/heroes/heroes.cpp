@@ -65,6 +65,11 @@ namespace
 {
     const size_t maxHeroCount = 71;
 
+    const std::vector<MP2::MapObjectType> moraleObjectTypes{ MP2::OBJ_BUOY,      MP2::OBJ_OASIS,        MP2::OBJ_WATERINGHOLE, MP2::OBJ_TEMPLE,
+                                                             MP2::OBJ_GRAVEYARD, MP2::OBJ_DERELICTSHIP, MP2::OBJ_SHIPWRECK };
+
+    const std::vector<MP2::MapObjectType> luckObjectTypes{ MP2::OBJ_MERMAID, MP2::OBJ_FAERIERING, MP2::OBJ_FOUNTAIN, MP2::OBJ_IDOL, MP2::OBJ_PYRAMID };
+
     int ObjectVisitedModifiersResult( const std::vector<MP2::MapObjectType> & objectTypes, const Heroes & hero, std::string * strs )
     {
         int result = 0;
@@ -617,21 +622,24 @@ int Heroes::GetMoraleWithModificators( std::string * strs ) const
     result += Skill::GetLeadershipModifiers( GetLevelSkill( Skill::Secondary::LEADERSHIP ), strs );
 
     // object visited
-    const std::vector<MP2::MapObjectType> objectTypes{ MP2::OBJ_BUOY,      MP2::OBJ_OASIS,        MP2::OBJ_WATERINGHOLE, MP2::OBJ_TEMPLE,
-                                                       MP2::OBJ_GRAVEYARD, MP2::OBJ_DERELICTSHIP, MP2::OBJ_SHIPWRECK };
-    result += ObjectVisitedModifiersResult( objectTypes, *this, strs );
+    result += strs == nullptr ? getVisitedObjectsModifiers().morale : ObjectVisitedModifiersResult( moraleObjectTypes, *this, strs );
 
     // bonus artifact
     result += GetMoraleModificator( strs );
 
     // A special artifact ability presence must be the last check.
-    const Artifact maxMoraleArtifact = bag_artifacts.getFirstArtifactWithBonus( fheroes2::ArtifactBonusType::MAXIMUM_MORALE );
-    if ( maxMoraleArtifact.isValid() ) {
-        if ( strs != nullptr ) {
+    if ( strs == nullptr ) {
+        if ( getArtifactBonuses().hasMaximumMorale ) {
+            result = Morale::BLOOD;
+        }
+    }
+    else {
+        const Artifact maxMoraleArtifact = bag_artifacts.getFirstArtifactWithBonus( fheroes2::ArtifactBonusType::MAXIMUM_MORALE );
+        if ( maxMoraleArtifact.isValid() ) {
             *strs += maxMoraleArtifact.GetName();
             *strs += _( " gives you maximum morale" );
+            result = Morale::BLOOD;
         }
-        result = Morale::BLOOD;
     }
 
     return Morale::Normalize( result );
@@ -650,24 +658,39 @@ int Heroes::GetLuckWithModificators( std::string * strs ) const
     result += Skill::GetLuckModifiers( GetLevelSkill( Skill::Secondary::LUCK ), strs );
 
     // object visited
-    const std::vector<MP2::MapObjectType> objectTypes{ MP2::OBJ_MERMAID, MP2::OBJ_FAERIERING, MP2::OBJ_FOUNTAIN, MP2::OBJ_IDOL, MP2::OBJ_PYRAMID };
-    result += ObjectVisitedModifiersResult( objectTypes, *this, strs );
+    result += strs == nullptr ? getVisitedObjectsModifiers().luck : ObjectVisitedModifiersResult( luckObjectTypes, *this, strs );
 
     // bonus artifact
     result += GetLuckModificator( strs );
 
-    const Artifact maxLuckArtifact = bag_artifacts.getFirstArtifactWithBonus( fheroes2::ArtifactBonusType::MAXIMUM_LUCK );
-    if ( maxLuckArtifact.isValid() ) {
-        if ( strs != nullptr ) {
+    if ( strs == nullptr ) {
+        if ( getArtifactBonuses().hasMaximumLuck ) {
+            result = Luck::IRISH;
+        }
+    }
+    else {
+        const Artifact maxLuckArtifact = bag_artifacts.getFirstArtifactWithBonus( fheroes2::ArtifactBonusType::MAXIMUM_LUCK );
+        if ( maxLuckArtifact.isValid() ) {
             *strs += maxLuckArtifact.GetName();
             *strs += _( " gives you maximum luck" );
+            result = Luck::IRISH;
         }
-        result = Luck::IRISH;
     }
 
     return Luck::Normalize( result );
 }
 
+const Heroes::VisitedObjectsModifiers & Heroes::getVisitedObjectsModifiers() const
+{
+    if ( !_visitedObjectsModifiers.isValid ) {
+        _visitedObjectsModifiers.morale = ObjectVisitedModifiersResult( moraleObjectTypes, *this, nullptr );
+        _visitedObjectsModifiers.luck = ObjectVisitedModifiersResult( luckObjectTypes, *this, nullptr );
+        _visitedObjectsModifiers.isValid = true;
+    }
+
+    return _visitedObjectsModifiers;
+}
+
 bool Heroes::Recruit( const int col, const fheroes2::Point & pt )
 {
     if ( GetColor() != Color::NONE ) {
@@ -735,7 +758,9 @@ void Heroes::ActionNewDay( void )
     ReplenishSpellPoints();
 
     // remove day visit object
-    visit_object.remove_if( Visit::isDayLife );
+    if ( visit_object.removeIf( Visit::isDayLife ) ) {
+        _visitedObjectsModifiers.isValid = false;
+    }
 
     // new day, new capacities
     ResetModes( SAVE_MP_POINTS );
@@ -744,19 +769,25 @@ void Heroes::ActionNewDay( void )
 void Heroes::ActionNewWeek( void )
 {
     // remove week visit object
-    visit_object.remove_if( Visit::isWeekLife );
+    if ( visit_object.removeIf( Visit::isWeekLife ) ) {
+        _visitedObjectsModifiers.isValid = false;
+    }
 }
 
 void Heroes::ActionNewMonth( void )
 {
     // remove month visit object
-    visit_object.remove_if( Visit::isMonthLife );
+    if ( visit_object.removeIf( Visit::isMonthLife ) ) {
+        _visitedObjectsModifiers.isValid = false;
+    }
 }
 
 void Heroes::ActionAfterBattle( void )
 {
     // remove month visit object
-    visit_object.remove_if( Visit::isBattleLife );
+    if ( visit_object.removeIf( Visit::isBattleLife ) ) {
+        _visitedObjectsModifiers.isValid = false;
+    }
 
     SetModes( ACTION );
 }
@@ -846,7 +877,7 @@ bool Heroes::isVisited( const Maps::Tiles & tile, Visit::type_t type ) const
     if ( Visit::GLOBAL == type )
         return GetKingdom().isVisited( index, objectType );
 
-    return visit_object.end() != std::find( visit_object.begin(), visit_object.end(), IndexObject( index, objectType ) );
+    return visit_object.isVisited( index, objectType );
 }
 
 bool Heroes::isObjectTypeVisited( const MP2::MapObjectType objectType, Visit::type_t type ) const
@@ -854,7 +885,7 @@ bool Heroes::isObjectTypeVisited( const MP2::MapObjectType objectType, Visit::ty
     if ( Visit::GLOBAL == type )
         return GetKingdom().isVisited( objectType );
 
-    return std::any_of( visit_object.begin(), visit_object.end(), [objectType]( const IndexObject & v ) { return v.isObject( objectType ); } );
+    return visit_object.isVisited( objectType );
 }
 
 void Heroes::SetVisited( s32 index, Visit::type_t type )
@@ -865,8 +896,8 @@ void Heroes::SetVisited( s32 index, Visit::type_t type )
     if ( Visit::GLOBAL == type ) {
         GetKingdom().SetVisited( index, objectType );
     }
-    else if ( !isVisited( tile ) && MP2::OBJ_ZERO != objectType ) {
-        visit_object.push_front( IndexObject( index, objectType ) );
+    else if ( MP2::OBJ_ZERO != objectType && visit_object.add( index, objectType ) ) {
+        _visitedObjectsModifiers.isValid = false;
     }
 }
 
@@ -911,8 +942,8 @@ void Heroes::SetVisitedWideTile( s32 index, const MP2::MapObjectType objectType,
 
 void Heroes::markHeroMeeting( int heroID )
 {
-    if ( heroID < UNKNOWN && !hasMetWithHero( heroID ) )
-        visit_object.push_front( IndexObject( heroID, MP2::OBJ_HEROES ) );
+    if ( heroID < UNKNOWN )
+        visit_object.add( heroID, MP2::OBJ_HEROES );
 }
 
 void Heroes::unmarkHeroMeeting()
@@ -923,14 +954,14 @@ void Heroes::unmarkHeroMeeting()
             continue;
         }
 
-        hero->visit_object.remove( IndexObject( hid, MP2::OBJ_HEROES ) );
-        visit_object.remove( IndexObject( hero->hid, MP2::OBJ_HEROES ) );
+        hero->visit_object.remove( hid, MP2::OBJ_HEROES );
+        visit_object.remove( hero->hid, MP2::OBJ_HEROES );
     }
 }
 
 bool Heroes::hasMetWithHero( int heroID ) const
 {
-    return visit_object.end() != std::find( visit_object.begin(), visit_object.end(), IndexObject( heroID, MP2::OBJ_HEROES ) );
+    return visit_object.isVisited( heroID, MP2::OBJ_HEROES );
 }
 
 bool Heroes::isLosingGame() const
@@ -1738,7 +1769,8 @@ std::string Heroes::String( void ) const
 
     if ( !visit_object.empty() ) {
         os << "visit objects   : ";
-        for ( std::list<IndexObject>::const_iterator it = visit_object.begin(); it != visit_object.end(); ++it )
+        const std::vector<IndexObject> & visits = visit_object.getVisits();
+        for ( std::vector<IndexObject>::const_reverse_iterator it = visits.rbegin(); it != visits.rend(); ++it )
             os << MP2::StringObject( static_cast<MP2::MapObjectType>( ( *it ).second ) ) << "(" << ( *it ).first << "), ";
         os << std::endl;
     }
@@ -2078,6 +2110,7 @@ StreamBase & operator>>( StreamBase & msg, Heroes & hero )
     hero.patrol_center = fheroes2::Point( patrolX, patrolY );
 
     msg >> hero.patrol_square >> hero.visit_object >> hero._lastGroundRegion;
+    hero._visitedObjectsModifiers.isValid = false;
 
     hero.army.SetCommander( &hero );
     return msg;
@@ -451,9 +451,22 @@ private:
     fheroes2::Point patrol_center;
     int patrol_square;
 
-    std::list<IndexObject> visit_object;
+    VisitedObjects visit_object;
     uint32_t _lastGroundRegion = 0;
 
+    // Morale and luck modifiers of the visited objects
+    struct VisitedObjectsModifiers
+    {
+        int morale = 0;
+        int luck = 0;
+        bool isValid = false;
+    };
+
+    // Modifiers are calculated again only after the list of visited objects changes
+    const VisitedObjectsModifiers & getVisitedObjectsModifiers() const;
+
+    mutable VisitedObjectsModifiers _visitedObjectsModifiers;
+
     RedrawIndex _redrawIndex;
 
     mutable int _alphaValue;
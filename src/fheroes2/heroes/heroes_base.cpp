@@ -155,11 +155,36 @@ bool HeroBase::hasArtifact( const Artifact & art ) const
     return bag_artifacts.isPresentArtifact( art );
 }
 
+const HeroBase::ArtifactBonuses & HeroBase::getArtifactBonuses() const
+{
+    // Artifacts are modified directly through the bag in many places, so changes are detected by comparing the artifacts
+    if ( _artifactBonuses.artifacts == bag_artifacts ) {
+        return _artifactBonuses;
+    }
+
+    _artifactBonuses.artifacts = bag_artifacts;
+
+    _artifactBonuses.attack = bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::ATTACK_SKILL );
+    _artifactBonuses.defense = bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::DEFENCE_SKILL );
+    _artifactBonuses.power = bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::SPELL_POWER_SKILL )
+                             - bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactCurseType::SPELL_POWER_SKILL );
+    _artifactBonuses.knowledge = bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::KNOWLEDGE_SKILL );
+    _artifactBonuses.morale = bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::MORALE )
+                              - bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactCurseType::MORALE );
+    _artifactBonuses.seaMorale = bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::SEA_BATTLE_MORALE_BOOST );
+    _artifactBonuses.luck = bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::LUCK );
+    _artifactBonuses.seaLuck = bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::SEA_BATTLE_LUCK_BOOST );
+    _artifactBonuses.hasMaximumMorale = bag_artifacts.getFirstArtifactWithBonus( fheroes2::ArtifactBonusType::MAXIMUM_MORALE ).isValid();
+    _artifactBonuses.hasMaximumLuck = bag_artifacts.getFirstArtifactWithBonus( fheroes2::ArtifactBonusType::MAXIMUM_LUCK ).isValid();
+
+    return _artifactBonuses;
+}
+
 int HeroBase::GetAttackModificator( std::string * strs ) const
 {
     int result = 0;
     if ( strs == nullptr ) {
-        result += bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::ATTACK_SKILL );
+        result += getArtifactBonuses().attack;
     }
     else {
         result += bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::ATTACK_SKILL, *strs );
@@ -178,7 +203,7 @@ int HeroBase::GetDefenseModificator( std::string * strs ) const
 {
     int result = 0;
     if ( strs == nullptr ) {
-        result += bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::DEFENCE_SKILL );
+        result += getArtifactBonuses().defense;
     }
     else {
         result += bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::DEFENCE_SKILL, *strs );
@@ -197,8 +222,7 @@ int HeroBase::GetPowerModificator( std::string * strs ) const
 {
     int result = 0;
     if ( strs == nullptr ) {
-        result += bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::SPELL_POWER_SKILL );
-        result -= bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactCurseType::SPELL_POWER_SKILL );
+        result += getArtifactBonuses().power;
     }
     else {
         result += bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::SPELL_POWER_SKILL, *strs );
@@ -218,7 +242,7 @@ int HeroBase::GetKnowledgeModificator( std::string * strs ) const
 {
     int result = 0;
     if ( strs == nullptr ) {
-        result += bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::KNOWLEDGE_SKILL );
+        result += getArtifactBonuses().knowledge;
     }
     else {
         result += bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::KNOWLEDGE_SKILL, *strs );
@@ -246,12 +270,11 @@ int HeroBase::GetMoraleModificator( std::string * strs ) const
     result += GetArmy().GetMoraleModificator( strs );
 
     if ( strs == nullptr ) {
-        result += bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::MORALE );
+        const ArtifactBonuses & bonuses = getArtifactBonuses();
+        result += bonuses.morale;
         if ( Modes( Heroes::SHIPMASTER ) ) {
-            result += bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::SEA_BATTLE_MORALE_BOOST );
+            result += bonuses.seaMorale;
         }
-
-        result -= bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactCurseType::MORALE );
     }
     else {
         result += bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::MORALE, *strs );
@@ -278,9 +301,10 @@ int HeroBase::GetLuckModificator( std::string * strs ) const
     result += GetArmy().GetLuckModificator( strs );
 
     if ( strs == nullptr ) {
-        result += bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::LUCK );
+        const ArtifactBonuses & bonuses = getArtifactBonuses();
+        result += bonuses.luck;
         if ( Modes( Heroes::SHIPMASTER ) ) {
-            result += bag_artifacts.getTotalArtifactEffectValue( fheroes2::ArtifactBonusType::SEA_BATTLE_LUCK_BOOST );
+            result += bonuses.seaLuck;
         }
     }
     else {
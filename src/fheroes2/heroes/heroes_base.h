@@ -132,11 +132,35 @@ protected:
     friend StreamBase & operator<<( StreamBase &, const HeroBase & );
     friend StreamBase & operator>>( StreamBase &, HeroBase & );
 
+    // Artifact bonuses to primary skills, morale and luck
+    struct ArtifactBonuses
+    {
+        // Artifacts the bonuses below are calculated for
+        BagArtifacts artifacts;
+
+        int32_t attack = 0;
+        int32_t defense = 0;
+        int32_t power = 0;
+        int32_t knowledge = 0;
+        int32_t morale = 0;
+        int32_t seaMorale = 0;
+        int32_t luck = 0;
+        int32_t seaLuck = 0;
+        bool hasMaximumMorale = false;
+        bool hasMaximumLuck = false;
+    };
+
+    // Bonuses are calculated again only when the artifacts of the hero change
+    const ArtifactBonuses & getArtifactBonuses() const;
+
     uint32_t magic_point;
     uint32_t move_point;
 
     SpellBook spell_book;
     BagArtifacts bag_artifacts;
+
+private:
+    mutable ArtifactBonuses _artifactBonuses;
 };
 
 StreamBase & operator<<( StreamBase &, const HeroBase & );
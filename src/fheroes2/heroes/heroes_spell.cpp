@@ -660,6 +660,8 @@ bool ActionSpellSetGuardian( Heroes & hero, const Spell & spell )
         }
 
         world.GetCapturedObject( tile.GetIndex() ).GetTroop().Set( Monster( spell ), count );
+        world.resetTileArmyStrength( tile.GetIndex() );
+        world.invalidatePathfinder( tile.GetIndex() );
         return true;
     }
 
@@ -198,7 +198,7 @@ void Kingdom::ActionNewDay( void )
         AddFundsResource( ( *it ).resource );
 
     // remove day visit object
-    visit_object.remove_if( Visit::isDayLife );
+    visit_object.removeIf( Visit::isDayLife );
 }
 
 void Kingdom::ActionNewWeek( void )
@@ -214,7 +214,7 @@ void Kingdom::ActionNewWeek( void )
     }
 
     // remove week visit object
-    visit_object.remove_if( Visit::isWeekLife );
+    visit_object.removeIf( Visit::isWeekLife );
 
     // Settle a new set of recruits
     GetRecruits();
@@ -223,7 +223,7 @@ void Kingdom::ActionNewWeek( void )
 void Kingdom::ActionNewMonth( void )
 {
     // remove month visit object
-    visit_object.remove_if( Visit::isMonthLife );
+    visit_object.removeIf( Visit::isMonthLife );
 }
 
 void Kingdom::AddHeroes( Heroes * hero )
@@ -369,27 +369,25 @@ bool Kingdom::isVisited( const Maps::Tiles & tile ) const
 
 bool Kingdom::isVisited( s32 index, const MP2::MapObjectType objectType ) const
 {
-    std::list<IndexObject>::const_iterator it = std::find_if( visit_object.begin(), visit_object.end(), [index]( const IndexObject & v ) { return v.isIndex( index ); } );
-    return visit_object.end() != it && ( *it ).isObject( objectType );
+    return visit_object.isVisited( index, objectType );
 }
 
 /* return true if object visited */
 bool Kingdom::isVisited( const MP2::MapObjectType objectType ) const
 {
-    return std::any_of( visit_object.begin(), visit_object.end(), [objectType]( const IndexObject & v ) { return v.isObject( objectType ); } );
+    return visit_object.isVisited( objectType );
 }
 
 uint32_t Kingdom::CountVisitedObjects( const MP2::MapObjectType objectType ) const
 {
-    // Safe to downcast as we don't deal with gigantic amount of data.
-    return static_cast<uint32_t>( std::count_if( visit_object.begin(), visit_object.end(), [objectType]( const IndexObject & v ) { return v.isObject( objectType ); } ) );
+    return visit_object.count( objectType );
 }
 
 /* set visited cell */
 void Kingdom::SetVisited( s32 index, const MP2::MapObjectType objectType = MP2::OBJ_ZERO )
 {
-    if ( !isVisited( index, objectType ) && objectType != MP2::OBJ_ZERO )
-        visit_object.push_front( IndexObject( index, objectType ) );
+    if ( objectType != MP2::OBJ_ZERO )
+        visit_object.add( index, objectType );
 }
 
 bool Kingdom::isValidKingdomObject( const Maps::Tiles & tile, const MP2::MapObjectType objectType ) const
@@ -502,6 +500,9 @@ void Kingdom::SetVisitTravelersTent( int col )
 {
     // visited_tents_color is a bitfield
     visited_tents_colors |= ( 1 << col );
+
+    // Barriers of this color are no longer obstacles for the AI
+    world.resetPathfinder();
 }
 
 bool Kingdom::IsVisitTravelersTent( int col ) const
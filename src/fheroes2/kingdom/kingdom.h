@@ -173,7 +173,7 @@ private:
 
     Recruits recruits;
 
-    std::list<IndexObject> visit_object;
+    VisitedObjects visit_object;
 
     Puzzle puzzle_maps;
     u32 visited_tents_colors;
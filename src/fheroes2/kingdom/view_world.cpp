@@ -28,10 +28,13 @@
 #include "image.h"
 #include "interface_border.h"
 #include "maps.h"
+#include "maps_tiles.h"
+#include "players.h"
 #include "settings.h"
 #include "tools.h"
 #include "world.h"
 
+#include <algorithm>
 #include <cassert>
 
 // #define VIEWWORLD_DEBUG_ZOOM_LEVEL // Activate this when you want to debug this window. It will provide an extra zoom level at 1:1 scale
@@ -131,26 +134,51 @@ namespace
         }
     }
 
+    // Returns a hash of everything which affects the look of the tile on the world map
+    uint32_t getTileHash( const Maps::Tiles & tile, const bool isFogDrawn, const int fogColors )
+    {
+        uint32_t hash = 0;
+
+        fheroes2::hashCombine( hash, tile.TileSpriteIndex() );
+        fheroes2::hashCombine( hash, tile.TileSpriteShape() );
+        fheroes2::hashCombine( hash, static_cast<int>( tile.GetObject() ) );
+        fheroes2::hashCombine( hash, tile.GetObjectTileset() );
+        fheroes2::hashCombine( hash, tile.GetObjectSpriteIndex() );
+        fheroes2::hashCombine( hash, tile.GetQuantity1() );
+        fheroes2::hashCombine( hash, tile.GetQuantity2() );
+        fheroes2::hashCombine( hash, tile.GetQuantity3() );
+
+        for ( const Maps::TilesAddon & addon : tile.getLevel1Addons() ) {
+            fheroes2::hashCombine( hash, addon.object );
+            fheroes2::hashCombine( hash, addon.index );
+        }
+
+        for ( const Maps::TilesAddon & addon : tile.getLevel2Addons() ) {
+            fheroes2::hashCombine( hash, addon.object );
+            fheroes2::hashCombine( hash, addon.index );
+        }
+
+        if ( isFogDrawn ) {
+            fheroes2::hashCombine( hash, tile.isFog( fogColors ) );
+        }
+
+        return hash;
+    }
+
+    // Images of the complete world map for all zoom levels. They are kept while the game goes on and only the blocks of the map
+    // which have been changed since the previous update are drawn again.
     struct CacheForMapWithResources
     {
         std::vector<fheroes2::Image> cachedImages; // One image per zoom Level
 
-        CacheForMapWithResources() = delete;
-
-        // Compute complete world map, and save it for all zoom levels
-        explicit CacheForMapWithResources( const bool revealAll )
+        void update( const bool revealAll )
         {
 #ifdef VIEWWORLD_DEBUG_ZOOM_LEVEL
-            cachedImages.resize( 4 );
+            const size_t zoomLevelCount = 4;
 #else
-            cachedImages.resize( 3 );
+            const size_t zoomLevelCount = 3;
 #endif
 
-            for ( size_t i = 0; i < cachedImages.size(); ++i ) {
-                cachedImages[i].resize( world.w() * tileSizePerZoomLevel[i], world.h() * tileSizePerZoomLevel[i] );
-                cachedImages[i]._disableTransformLayer();
-            }
-
             const int32_t blockSizeX = TILEWIDTH * 18;
             const int32_t blockSizeY = TILEWIDTH * 18;
 
@@ -161,6 +189,61 @@ namespace
             assert( worldWidthPixels % blockSizeX == 0 );
             assert( worldHeightPixels % blockSizeY == 0 );
 
+            const int32_t blockCountX = worldWidthPixels / blockSizeX;
+            const int32_t blockCountY = worldHeightPixels / blockSizeY;
+
+            if ( cachedImages.size() != zoomLevelCount || cachedImages[0].width() != world.w() * tileSizePerZoomLevel[0]
+                 || cachedImages[0].height() != world.h() * tileSizePerZoomLevel[0] ) {
+                cachedImages.resize( zoomLevelCount );
+
+                for ( size_t i = 0; i < cachedImages.size(); ++i ) {
+                    cachedImages[i].resize( world.w() * tileSizePerZoomLevel[i], world.h() * tileSizePerZoomLevel[i] );
+                    cachedImages[i]._disableTransformLayer();
+                }
+
+                _blockHashes.clear();
+            }
+
+            // Another map of the same size could have been loaded, so none of the blocks can be trusted
+            if ( _worldGeneration != world.getGeneration() ) {
+                _worldGeneration = world.getGeneration();
+
+                _blockHashes.clear();
+            }
+
+            const bool isCacheEmpty = _blockHashes.empty();
+            _blockHashes.resize( static_cast<size_t>( blockCountX * blockCountY ), 0 );
+
+            const bool isFogDrawn = !revealAll;
+            const int fogColors = Players::FriendColors();
+
+            const int32_t tileCount = static_cast<int32_t>( world.getSize() );
+            std::vector<uint32_t> tileHashes( static_cast<size_t>( tileCount ) );
+            for ( int32_t index = 0; index < tileCount; ++index ) {
+                tileHashes[index] = getTileHash( world.GetTiles( index ), isFogDrawn, fogColors );
+            }
+
+            // Objects of the tiles near a block can overlap it so these tiles affect the block as well
+            const int32_t blockMargin = 2;
+            const int32_t blockTileCountX = blockSizeX / TILEWIDTH;
+            const int32_t blockTileCountY = blockSizeY / TILEWIDTH;
+
+            auto getBlockHash = [&tileHashes, blockTileCountX, blockTileCountY]( const int32_t blockX, const int32_t blockY ) {
+                const int32_t minX = std::max( blockX * blockTileCountX - blockMargin, 0 );
+                const int32_t minY = std::max( blockY * blockTileCountY - blockMargin, 0 );
+                const int32_t maxX = std::min( ( blockX + 1 ) * blockTileCountX + blockMargin, world.w() );
+                const int32_t maxY = std::min( ( blockY + 1 ) * blockTileCountY + blockMargin, world.h() );
+
+                uint32_t hash = 0;
+                for ( int32_t y = minY; y < maxY; ++y ) {
+                    for ( int32_t x = minX; x < maxX; ++x ) {
+                        fheroes2::hashCombine( hash, tileHashes[y * world.w() + x] );
+                    }
+                }
+
+                return hash;
+            };
+
             // Create temporary image where we will draw blocks of the main map on
             fheroes2::Image temporaryImg( blockSizeX, blockSizeY );
             temporaryImg._disableTransformLayer();
@@ -177,9 +260,21 @@ namespace
             drawingFlags ^= Interface::RedrawLevelType::LEVEL_HEROES;
 #endif
 
-            // Draw sub-blocks of the main map, and resize them to draw them on lower-res cached versions:
-            for ( int x = 0; x < worldWidthPixels; x += blockSizeX ) {
-                for ( int y = 0; y < worldHeightPixels; y += blockSizeY ) {
+            // Draw the changed sub-blocks of the main map, and resize them to draw them on lower-res cached versions:
+            for ( int32_t blockX = 0; blockX < blockCountX; ++blockX ) {
+                for ( int32_t blockY = 0; blockY < blockCountY; ++blockY ) {
+                    const uint32_t blockHash = getBlockHash( blockX, blockY );
+                    uint32_t & cachedBlockHash = _blockHashes[blockY * blockCountX + blockX];
+
+                    if ( !isCacheEmpty && cachedBlockHash == blockHash ) {
+                        continue;
+                    }
+
+                    cachedBlockHash = blockHash;
+
+                    const int x = blockX * blockSizeX;
+                    const int y = blockY * blockSizeY;
+
                     gamearea.SetCenterInPixels( { x + blockSizeX / 2, y + blockSizeY / 2 } );
                     gamearea.Redraw( temporaryImg, drawingFlags );
 
@@ -196,8 +291,27 @@ namespace
             fheroes2::Save( cachedImages[3], Settings::Get().MapsName() + saveFilePrefix + ".bmp" );
 #endif
         }
+
+    private:
+        // Hash of the tiles which affect every block of the map at the moment when the block was drawn
+        std::vector<uint32_t> _blockHashes;
+
+        // Generation of the world for which the blocks were drawn, see World::getGeneration()
+        uint32_t _worldGeneration = 0;
     };
 
+    // Returns the cache for the given mode which is up to date with the current state of the world
+    CacheForMapWithResources & getCacheForMapWithResources( const bool revealAll )
+    {
+        static CacheForMapWithResources cacheWithFog;
+        static CacheForMapWithResources cacheWithoutFog;
+
+        CacheForMapWithResources & cache = revealAll ? cacheWithoutFog : cacheWithFog;
+        cache.update( revealAll );
+
+        return cache;
+    }
+
     void DrawWorld( const ViewWorld::ZoomROIs & ROI, CacheForMapWithResources & cache )
     {
         fheroes2::Display & display = fheroes2::Display::instance();
@@ -539,7 +653,7 @@ void ViewWorld::ViewWorldWindow( const int color, const ViewWorldMode mode, Inte
 
     ZoomROIs currentROI( ZoomLevel::ZoomLevel2, viewCenterInPixels );
 
-    CacheForMapWithResources cache( mode == ViewWorldMode::ViewAll );
+    CacheForMapWithResources & cache = getCacheForMapWithResources( mode == ViewWorldMode::ViewAll );
 
     DrawWorld( currentROI, cache );
     DrawObjectsIcons( color, mode, currentROI );
@@ -52,6 +52,11 @@ const char * Maps::Ground::String( int ground )
 }
 
 uint32_t Maps::Ground::GetPenalty( const Maps::Tiles & tile, uint32_t level )
+{
+    return GetPenalty( tile.GetGround(), level );
+}
+
+uint32_t Maps::Ground::GetPenalty( const int ground, uint32_t level )
 {
     //              none   basc   advd   expr
     //    Desert    2.00   1.75   1.50   1.00
@@ -67,7 +72,7 @@ uint32_t Maps::Ground::GetPenalty( const Maps::Tiles & tile, uint32_t level )
 
     uint32_t result = defaultGroundPenalty;
 
-    switch ( tile.GetGround() ) {
+    switch ( ground ) {
     case DESERT:
         switch ( level ) {
         case Skill::Level::EXPERT:
@@ -39,12 +39,12 @@
 
 namespace
 {
-    std::vector<int32_t> getTileToClearIndicies( const int32_t tileIndex, int scouteValue, const int playerColor )
+    // Calls the given function for the index of every tile which is revealed by the scouting from the given tile
+    template <typename Function>
+    void forEachTileToClear( const int32_t tileIndex, int scouteValue, const int playerColor, Function function )
     {
-        std::vector<int32_t> indicies;
-
         if ( scouteValue <= 0 || !Maps::isValidAbsIndex( tileIndex ) ) {
-            return indicies;
+            return;
         }
 
         const fheroes2::Point center = Maps::GetPoint( tileIndex );
@@ -67,10 +67,17 @@ namespace
                 const int32_t dx = x - center.x;
                 const int32_t dy = y - center.y;
                 if ( revealRadiusSquared >= dx * dx + dy * dy ) {
-                    indicies.emplace_back( Maps::GetIndexFromAbsPoint( x, y ) );
+                    function( Maps::GetIndexFromAbsPoint( x, y ) );
                 }
             }
         }
+    }
+
+    std::vector<int32_t> getTileToClearIndicies( const int32_t tileIndex, const int scouteValue, const int playerColor )
+    {
+        std::vector<int32_t> indicies;
+
+        forEachTileToClear( tileIndex, scouteValue, playerColor, [&indicies]( const int32_t index ) { indicies.emplace_back( index ); } );
 
         return indicies;
     }
@@ -383,16 +390,14 @@ void Maps::ClearFog( const int32_t tileIndex, const int scouteValue, const int p
 
 int32_t Maps::getFogTileCountToBeRevealed( const int32_t tileIndex, const int scouteValue, const int playerColor )
 {
-    const std::vector<int32_t> tileIndicies = getTileToClearIndicies( tileIndex, scouteValue, playerColor );
-
     int32_t tileCount = 0;
 
-    for ( const int32_t index : tileIndicies ) {
-        const Maps::Tiles & tile = world.GetTiles( index );
-        if ( tile.isFog( playerColor ) ) {
+    // This function is called for many tiles in a row by AI so avoid storing the indexes
+    forEachTileToClear( tileIndex, scouteValue, playerColor, [&tileCount, playerColor]( const int32_t index ) {
+        if ( world.GetTiles( index ).isFog( playerColor ) ) {
             ++tileCount;
         }
-    }
+    } );
 
     return tileCount;
 }
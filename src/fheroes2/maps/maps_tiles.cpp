@@ -695,7 +695,7 @@ std::pair<int, int> Maps::Tiles::ColorRaceFromHeroSprite( const uint32_t heroSpr
 /* Maps::Addons */
 void Maps::Addons::Remove( u32 uniq )
 {
-    remove_if( [uniq]( const TilesAddon & v ) { return v.isUniq( uniq ); } );
+    erase( std::remove_if( begin(), end(), [uniq]( const TilesAddon & v ) { return v.isUniq( uniq ); } ), end() );
 }
 
 u32 PackTileSpriteIndex( u32 index, u32 shape ) /* index max: 0x3FFF, shape value: 0, 1, 2, 3 */
@@ -780,7 +780,10 @@ MP2::MapObjectType Maps::Tiles::GetObject( bool ignoreObjectUnderHero /* true */
 void Maps::Tiles::SetObject( const MP2::MapObjectType objectType )
 {
     mp2_object = objectType;
-    world.resetPathfinder();
+    world.updateTileData( *this );
+    world.invalidatePathfinder( _index );
+    world.resetTileArmyStrength( _index );
+    world.invalidateRadarTiles( _index );
 }
 
 void Maps::Tiles::setBoat( int direction )
@@ -1057,6 +1060,8 @@ void Maps::Tiles::UpdateRegion( uint32_t newRegionID )
     else {
         _region = REGION_NODE_BLOCKED;
     }
+
+    world.updateTileData( *this );
 }
 
 u32 Maps::Tiles::GetObjectUID() const
@@ -1135,7 +1140,7 @@ void Maps::Tiles::AddonsSort()
 {
     // Push everything to the container and sort it by level.
     if ( objectTileset != 0 && objectIndex < 255 ) {
-        addons_level1.emplace_front( _level, uniq, objectTileset, objectIndex );
+        addons_level1.emplace( addons_level1.begin(), _level, uniq, objectTileset, objectIndex );
     }
 
     // Some original maps have issues with identifying tiles as roads. This code fixes it. It's not an ideal solution but works fine in most of cases.
@@ -1148,7 +1153,8 @@ void Maps::Tiles::AddonsSort()
         }
     }
 
-    addons_level1.sort( TilesAddon::PredicateSortRules1 );
+    // Keep the order of addons with the same priority
+    std::stable_sort( addons_level1.begin(), addons_level1.end(), TilesAddon::PredicateSortRules1 );
 
     if ( !addons_level1.empty() ) {
         const TilesAddon & highestPriorityAddon = addons_level1.back();
@@ -1160,6 +1166,10 @@ void Maps::Tiles::AddonsSort()
         addons_level1.pop_back();
     }
 
+    // Addons are rarely added after the map is loaded
+    addons_level1.shrink_to_fit();
+    addons_level2.shrink_to_fit();
+
     // Level 2 objects don't have any rendering priorities so they should be rendered first in queue first to render.
 }
 
@@ -1193,16 +1203,6 @@ bool Maps::Tiles::isWater( void ) const
     return 30 > TileSpriteIndex();
 }
 
-void Maps::Tiles::RedrawTile( fheroes2::Image & dst, const fheroes2::Rect & visibleTileROI, const Interface::GameArea & area ) const
-{
-    const fheroes2::Point & mp = Maps::GetPoint( _index );
-
-    if ( !( visibleTileROI & mp ) )
-        return;
-
-    area.DrawTile( dst, GetTileSurface(), mp );
-}
-
 void Maps::Tiles::RedrawEmptyTile( fheroes2::Image & dst, const fheroes2::Point & mp, const fheroes2::Rect & visibleTileROI, const Interface::GameArea & area )
 {
     if ( !( visibleTileROI & mp ) ) {
@@ -1586,7 +1586,7 @@ std::string Maps::Tiles::String( void ) const
     if ( MP2::isCaptureObject( GetObject( false ) ) ) {
         const CapturedObject & co = world.GetCapturedObject( _index );
 
-        os << "capture color   : " << Color::String( co.objcol.second ) << std::endl;
+        os << "capture color   : " << Color::String( co.GetColor() ) << std::endl;
         if ( co.guardians.isValid() ) {
             os << "capture guard   : " << co.guardians.GetName() << std::endl << "capture caunt   : " << co.guardians.GetCount() << std::endl;
         }
@@ -1625,19 +1625,23 @@ bool Maps::Tiles::isPassableFrom( const int direction, const bool fromWater, con
         return false;
     }
 
-    const bool tileIsWater = isWater();
+    return isPassableFrom( direction, fromWater, isWater(), mp2_object, tilePassable );
+}
 
+bool Maps::Tiles::isPassableFrom( const int direction, const bool fromWater, const bool tileIsWater, const MP2::MapObjectType objectType,
+                                  const uint16_t passability )
+{
     // From the water we can get either to the coast tile or to the water tile (provided there is no boat on this tile).
-    if ( fromWater && mp2_object != MP2::OBJ_COAST && ( !tileIsWater || mp2_object == MP2::OBJ_BOAT ) ) {
+    if ( fromWater && objectType != MP2::OBJ_COAST && ( !tileIsWater || objectType == MP2::OBJ_BOAT ) ) {
         return false;
     }
 
     // From the ground we can get to the water tile only if this tile contains a certain object.
-    if ( !fromWater && tileIsWater && mp2_object != MP2::OBJ_SHIPWRECK && mp2_object != MP2::OBJ_HEROES && mp2_object != MP2::OBJ_BOAT ) {
+    if ( !fromWater && tileIsWater && objectType != MP2::OBJ_SHIPWRECK && objectType != MP2::OBJ_HEROES && objectType != MP2::OBJ_BOAT ) {
         return false;
     }
 
-    return ( direction & tilePassable ) != 0;
+    return ( direction & passability ) != 0;
 }
 
 bool Maps::Tiles::isPassableTo( const int direction ) const
@@ -1653,6 +1657,8 @@ void Maps::Tiles::SetObjectPassable( bool pass )
             tilePassable |= Direction::TOP_LEFT;
         else
             tilePassable &= ~Direction::TOP_LEFT;
+
+        world.updateTileData( *this );
         break;
 
     default:
@@ -1688,6 +1694,48 @@ bool Maps::Tiles::hasSpriteAnimation() const
     return objectTileset & 1;
 }
 
+bool Maps::Tiles::isAnimated() const
+{
+    switch ( mp2_object ) {
+    case MP2::OBJ_HEROES:
+    case MP2::OBJ_MONSTER:
+    case MP2::OBJ_ABANDONEDMINE:
+        return true;
+    case MP2::OBJ_MINES:
+        if ( quantity3 == Spell::HAUNT ) {
+            return true;
+        }
+        break;
+    default:
+        break;
+    }
+
+    // Some animations start from the frame with index 0 so compare two consecutive frames instead of checking for a non-zero frame
+    const bool isValueSet = quantity2 != 0;
+    auto isAnimatedSprite = [isValueSet]( const uint8_t object, const uint8_t index ) {
+        const int icn = MP2::GetICNObject( object );
+        return ICN::UNKNOWN != icn && ICN::AnimationFrame( icn, index, 0, isValueSet ) != ICN::AnimationFrame( icn, index, 1, isValueSet );
+    };
+
+    if ( isAnimatedSprite( objectTileset, objectIndex ) ) {
+        return true;
+    }
+
+    for ( const TilesAddon & addon : addons_level1 ) {
+        if ( isAnimatedSprite( addon.object, addon.index ) ) {
+            return true;
+        }
+    }
+
+    for ( const TilesAddon & addon : addons_level2 ) {
+        if ( isAnimatedSprite( addon.object, addon.index ) ) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 bool Maps::Tiles::isObject( const MP2::MapObjectType objectType ) const
 {
     return objectType == mp2_object;
@@ -1717,8 +1765,8 @@ Maps::TilesAddon * Maps::Tiles::FindFlags( void )
 
 void Maps::Tiles::removeFlags()
 {
-    addons_level1.remove_if( TilesAddon::isFlag32 );
-    addons_level2.remove_if( TilesAddon::isFlag32 );
+    addons_level1.erase( std::remove_if( addons_level1.begin(), addons_level1.end(), TilesAddon::isFlag32 ), addons_level1.end() );
+    addons_level2.erase( std::remove_if( addons_level2.begin(), addons_level2.end(), TilesAddon::isFlag32 ), addons_level2.end() );
 }
 
 void Maps::Tiles::CaptureFlags32( const MP2::MapObjectType objectType, int col )
@@ -1999,6 +2047,7 @@ void Maps::Tiles::RemoveObjectSprite( void )
     case MP2::OBJ_JAIL:
         RemoveJailSprite();
         tilePassable = DIRECTION_ALL;
+        world.updateTileData( *this );
         break;
     case MP2::OBJ_ARTIFACT: {
         const uint32_t uidArtifact = getObjectIdByICNType( ICN::OBJNARTI );
@@ -2019,6 +2068,7 @@ void Maps::Tiles::RemoveObjectSprite( void )
     }
     case MP2::OBJ_BARRIER:
         tilePassable = DIRECTION_ALL;
+        world.updateTileData( *this );
         // fall-through
     default:
         // remove shadow sprite from left cell
@@ -2219,35 +2269,33 @@ std::pair<uint32_t, uint32_t> Maps::Tiles::GetMonsterSpriteIndices( const Tiles
 
 void Maps::Tiles::ClearFog( int colors )
 {
+    const int clearedColors = fog_colors & colors;
+    if ( clearedColors == 0 ) {
+        return;
+    }
+
     fog_colors &= ~colors;
+
+    world.updateTileData( *this );
+    world.updateFogDirections( _index, clearedColors );
+    world.invalidateRadarTiles( _index );
+
+    // Fog makes tiles impassable for pathfinding
+    world.invalidatePathfinder( _index );
 }
 
 bool Maps::Tiles::isFogAllAround( const int color ) const
 {
-    const int32_t center = GetIndex();
-    const fheroes2::Point mp = Maps::GetPoint( center );
-    const int32_t width = world.w();
-    const int32_t height = world.h();
-
-    // Verify all tiles around the current one with radius of 2 to cover moving hero case as well.
-    for ( int32_t y = -2; y < 3; ++y ) {
-        const int32_t offsetY = mp.y + y;
-        if ( offsetY < 0 || offsetY >= height )
+    // Verify all tiles around the current one with radius of 2 to cover moving hero case as well. These tiles are the neighbours
+    // of the adjacent tiles, so it is enough to check fog directions of the adjacent tiles except the direction back to this tile.
+    for ( const int direction : Direction::All() ) {
+        if ( !Maps::isValidDirection( _index, direction ) ) {
             continue;
+        }
 
-        const int32_t centerY = center + y * width;
-
-        for ( int32_t x = -2; x < 3; ++x ) {
-            if ( x == 0 && y == 0 )
-                continue;
-
-            const int32_t offsetX = mp.x + x;
-            if ( offsetX < 0 || offsetX >= width )
-                continue;
-
-            if ( !world.GetTiles( centerY + x ).isFog( color ) ) {
-                return false;
-            }
+        const int fogDirections = world.getFogDirections( Maps::GetDirectionIndex( _index, direction ), color );
+        if ( ( fogDirections | Direction::Reflect( direction ) ) != DIRECTION_ALL ) {
+            return false;
         }
     }
 
@@ -2256,17 +2304,7 @@ bool Maps::Tiles::isFogAllAround( const int color ) const
 
 int Maps::Tiles::GetFogDirections( int color ) const
 {
-    int around = 0;
-    const Directions & directions = Direction::All();
-
-    for ( Directions::const_iterator it = directions.begin(); it != directions.end(); ++it )
-        if ( !Maps::isValidDirection( _index, *it ) || world.GetTiles( Maps::GetDirectionIndex( _index, *it ) ).isFog( color ) )
-            around |= *it;
-
-    if ( isFog( color ) )
-        around |= Direction::CENTER;
-
-    return around;
+    return world.getFogDirections( _index, color );
 }
 
 void Maps::Tiles::RedrawFogs( fheroes2::Image & dst, int color, const Interface::GameArea & area ) const
@@ -23,7 +23,7 @@
 #ifndef H2TILES_H
 #define H2TILES_H
 
-#include <list>
+#include <vector>
 
 #include "army_troop.h"
 #include "artifact.h"
@@ -69,7 +69,7 @@ namespace Maps
 
         ~TilesAddon() = default;
 
-        TilesAddon & operator=( const TilesAddon & ta ) = delete;
+        TilesAddon & operator=( const TilesAddon & ) = default;
 
         bool isUniq( const uint32_t id ) const
         {
@@ -95,7 +95,8 @@ namespace Maps
         uint8_t index;
     };
 
-    struct Addons : public std::list<TilesAddon>
+    // Most tiles have a few addons at most, so they are stored contiguously to avoid chasing list nodes while rendering the map
+    struct Addons : public std::vector<TilesAddon>
     {
         void Remove( u32 uniq );
     };
@@ -149,10 +150,15 @@ namespace Maps
 
         bool isObject( const MP2::MapObjectType objectType ) const;
         bool hasSpriteAnimation() const;
+        // Returns true if any image drawn on this tile depends on the current frame of map animation
+        bool isAnimated() const;
         // Checks whether it is possible to move into this tile from the specified direction under the specified conditions
         bool isPassableFrom( const int direction, const bool fromWater, const bool skipFog, const int heroColor ) const;
         // Checks whether it is possible to exit this tile in the specified direction
         bool isPassableTo( const int direction ) const;
+        // Passability rules of isPassableFrom() except fog for a tile with the given properties
+        static bool isPassableFrom( const int direction, const bool fromWater, const bool tileIsWater, const MP2::MapObjectType objectType,
+                                    const uint16_t passability );
         bool isRoad() const;
         bool isStream( void ) const;
         bool isShadow() const;
@@ -196,7 +202,6 @@ namespace Maps
         // Removes all ICN::FLAGS32 objects from this tile.
         void removeFlags();
 
-        void RedrawTile( fheroes2::Image & dst, const fheroes2::Rect & visibleTileROI, const Interface::GameArea & area ) const;
         static void RedrawEmptyTile( fheroes2::Image & dst, const fheroes2::Point & mp, const fheroes2::Rect & visibleTileROI, const Interface::GameArea & area );
         void RedrawBottom( fheroes2::Image & dst, const fheroes2::Rect & visibleTileROI, bool isPuzzleDraw, const Interface::GameArea & area ) const;
         void RedrawBottom4Hero( fheroes2::Image & dst, const fheroes2::Rect & visibleTileROI, const Interface::GameArea & area ) const;
@@ -242,6 +247,11 @@ namespace Maps
             return ( fog_colors & colors ) == colors;
         }
 
+        uint8_t getFogColors() const
+        {
+            return fog_colors;
+        }
+
         bool isFogAllAround( const int color ) const;
         void ClearFog( int color );
 
@@ -938,6 +938,9 @@ void Maps::Tiles::MonsterSetCount( u32 count )
 {
     quantity1 = count >> 8;
     quantity2 = 0x00FF & count;
+
+    world.resetTileArmyStrength( _index );
+    world.invalidatePathfinder( _index );
 }
 
 void Maps::Tiles::PlaceMonsterOnTile( Tiles & tile, const Monster & mons, const uint32_t count )
@@ -21,8 +21,10 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <algorithm>
+
+#include "serialize.h"
 #include "visit.h"
-#include "pairs.h"
 
 bool Visit::isDayLife( const IndexObject & visit )
 {
@@ -43,3 +45,90 @@ bool Visit::isBattleLife( const IndexObject & visit )
 {
     return MP2::isBattleLife( static_cast<MP2::MapObjectType>( visit.second ) );
 }
+
+bool VisitedObjects::add( const int32_t index, const MP2::MapObjectType objectType )
+{
+    if ( !_visitedObjects.insert( getKey( index, objectType ) ).second ) {
+        return false;
+    }
+
+    _visits.emplace_back( index, objectType );
+    ++_objectTypeCount[objectType];
+
+    return true;
+}
+
+void VisitedObjects::remove( const int32_t index, const MP2::MapObjectType objectType )
+{
+    if ( _visitedObjects.erase( getKey( index, objectType ) ) == 0 ) {
+        return;
+    }
+
+    _visits.erase( std::find( _visits.begin(), _visits.end(), IndexObject( index, objectType ) ) );
+    --_objectTypeCount[objectType];
+}
+
+bool VisitedObjects::removeIf( bool ( *predicate )( const IndexObject & ) )
+{
+    const size_t visitCount = _visits.size();
+
+    _visits.erase( std::remove_if( _visits.begin(), _visits.end(), predicate ), _visits.end() );
+
+    if ( _visits.size() == visitCount ) {
+        return false;
+    }
+
+    rebuildIndex();
+
+    return true;
+}
+
+void VisitedObjects::clear()
+{
+    _visits.clear();
+    _visitedObjects.clear();
+    _objectTypeCount.fill( 0 );
+}
+
+void VisitedObjects::rebuildIndex()
+{
+    _visitedObjects.clear();
+    _objectTypeCount.fill( 0 );
+
+    // Old saves may contain repeated visits of the same object, only the first one is kept
+    _visits.erase( std::remove_if( _visits.begin(), _visits.end(),
+                                   [this]( const IndexObject & visit ) {
+                                       if ( !_visitedObjects.insert( getKey( visit.first, visit.second ) ).second ) {
+                                           return true;
+                                       }
+
+                                       ++_objectTypeCount[static_cast<uint8_t>( visit.second )];
+                                       return false;
+                                   } ),
+                   _visits.end() );
+}
+
+StreamBase & operator<<( StreamBase & msg, const VisitedObjects & visitedObjects )
+{
+    // Visits used to be stored in a list with the most recent visit at the front, keep the same order for compatibility
+    const std::vector<IndexObject> & visits = visitedObjects._visits;
+
+    msg.put32( static_cast<uint32_t>( visits.size() ) );
+    for ( std::vector<IndexObject>::const_reverse_iterator it = visits.rbegin(); it != visits.rend(); ++it ) {
+        msg << *it;
+    }
+
+    return msg;
+}
+
+StreamBase & operator>>( StreamBase & msg, VisitedObjects & visitedObjects )
+{
+    std::vector<IndexObject> & visits = visitedObjects._visits;
+
+    msg >> visits;
+    std::reverse( visits.begin(), visits.end() );
+
+    visitedObjects.rebuildIndex();
+
+    return msg;
+}
@@ -24,7 +24,15 @@
 #ifndef H2MAPSVISIT_H
 #define H2MAPSVISIT_H
 
-class IndexObject;
+#include <array>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+#include "mp2.h"
+#include "pairs.h"
+
+class StreamBase;
 
 namespace Visit
 {
@@ -40,4 +48,64 @@ namespace Visit
     bool isBattleLife( const IndexObject & visit );
 }
 
+// Objects visited by a hero or a kingdom. Besides the list of visits it keeps a set of visited objects and the number of visited objects
+// of every type, so checking whether an object or an object type has been visited doesn't depend on the number of visits.
+class VisitedObjects
+{
+public:
+    bool isVisited( const int32_t index, const MP2::MapObjectType objectType ) const
+    {
+        return _visitedObjects.count( getKey( index, objectType ) ) > 0;
+    }
+
+    bool isVisited( const MP2::MapObjectType objectType ) const
+    {
+        return _objectTypeCount[objectType] > 0;
+    }
+
+    uint32_t count( const MP2::MapObjectType objectType ) const
+    {
+        return _objectTypeCount[objectType];
+    }
+
+    bool empty() const
+    {
+        return _visits.empty();
+    }
+
+    // Visits are stored in the order they were made, the most recent one is the last
+    const std::vector<IndexObject> & getVisits() const
+    {
+        return _visits;
+    }
+
+    // Returns false if the object has already been visited
+    bool add( const int32_t index, const MP2::MapObjectType objectType );
+
+    void remove( const int32_t index, const MP2::MapObjectType objectType );
+
+    // Removes all visits satisfying the given predicate, returns true if any visit was removed
+    bool removeIf( bool ( *predicate )( const IndexObject & ) );
+
+    void clear();
+
+private:
+    friend StreamBase & operator<<( StreamBase &, const VisitedObjects & );
+    friend StreamBase & operator>>( StreamBase &, VisitedObjects & );
+
+    static uint64_t getKey( const int32_t index, const int objectType )
+    {
+        return ( static_cast<uint64_t>( static_cast<uint32_t>( index ) ) << 8 ) | static_cast<uint8_t>( objectType );
+    }
+
+    void rebuildIndex();
+
+    std::vector<IndexObject> _visits;
+    std::unordered_set<uint64_t> _visitedObjects;
+    std::array<uint32_t, 256> _objectTypeCount{};
+};
+
+StreamBase & operator<<( StreamBase &, const VisitedObjects & );
+StreamBase & operator>>( StreamBase &, VisitedObjects & );
+
 #endif
@@ -195,13 +195,19 @@ void MapObjects::remove( u32 uid )
 
 CapturedObject & CapturedObjects::Get( s32 index )
 {
-    std::map<s32, CapturedObject> & my = *this;
-    return my[index];
+    const auto result = _objects.emplace( index, CapturedObject() );
+    if ( result.second ) {
+        _objectTiles[getObjectColorKey( MP2::OBJ_ZERO, Color::NONE )].insert( index );
+    }
+
+    return result.first->second;
 }
 
 void CapturedObjects::SetColor( s32 index, int col )
 {
-    Get( index ).SetColor( col );
+    CapturedObject & co = Get( index );
+
+    setObjectColor( index, co, ObjectColor( co.objcol.first, col ) );
 }
 
 void CapturedObjects::Set( s32 index, int obj, int col )
@@ -211,36 +217,29 @@ void CapturedObjects::Set( s32 index, int obj, int col )
     if ( co.GetColor() != col && co.guardians.isValid() )
         co.guardians.Reset();
 
-    co.Set( obj, col );
+    setObjectColor( index, co, ObjectColor( obj, col ) );
 }
 
 u32 CapturedObjects::GetCount( int obj, int col ) const
 {
-    u32 result = 0;
-
-    const ObjectColor objcol( obj, col );
+    const std::set<int32_t> * tiles = getObjectTiles( obj, col );
 
-    for ( const_iterator it = begin(); it != end(); ++it ) {
-        if ( objcol == ( *it ).second.objcol )
-            ++result;
-    }
-
-    return result;
+    return tiles ? static_cast<u32>( tiles->size() ) : 0;
 }
 
 u32 CapturedObjects::GetCountMines( int type, int col ) const
 {
     u32 result = 0;
 
-    const ObjectColor objcol1( MP2::OBJ_MINES, col );
-    const ObjectColor objcol2( MP2::OBJ_HEROES, col );
-
-    for ( const_iterator it = begin(); it != end(); ++it ) {
-        const ObjectColor & objcol = ( *it ).second.objcol;
+    for ( const int objectType : { MP2::OBJ_MINES, MP2::OBJ_HEROES } ) {
+        const std::set<int32_t> * tiles = getObjectTiles( objectType, col );
+        if ( tiles == nullptr ) {
+            continue;
+        }
 
-        if ( objcol == objcol1 || objcol == objcol2 ) {
+        for ( const int32_t tileIndex : *tiles ) {
             // scan for find mines
-            const uint8_t index = world.GetTiles( ( *it ).first ).GetObjectSpriteIndex();
+            const uint8_t index = world.GetTiles( tileIndex ).GetObjectSpriteIndex();
 
             // index sprite EXTRAOVR
             if ( 0 == index && Resource::ORE == type )
@@ -261,48 +260,60 @@ u32 CapturedObjects::GetCountMines( int type, int col ) const
 
 int CapturedObjects::GetColor( s32 index ) const
 {
-    const_iterator it = find( index );
-    return it != end() ? ( *it ).second.GetColor() : Color::NONE;
+    const auto it = _objects.find( index );
+    return it != _objects.end() ? it->second.GetColor() : Color::NONE;
 }
 
 void CapturedObjects::ClearFog( int colors )
 {
     // clear abroad objects
-    for ( const_iterator it = begin(); it != end(); ++it ) {
-        const ObjectColor & objcol = ( *it ).second.objcol;
+    for ( const auto & objectTiles : _objectTiles ) {
+        const int objectType = static_cast<int>( objectTiles.first >> 16 );
+        const int color = static_cast<int>( objectTiles.first & 0xFFFF );
 
-        if ( objcol.isColor( colors ) ) {
-            int scoute = 0;
+        if ( ( color & colors ) == 0 ) {
+            continue;
+        }
 
-            switch ( objcol.first ) {
-            case MP2::OBJ_MINES:
-            case MP2::OBJ_ALCHEMYLAB:
-            case MP2::OBJ_SAWMILL:
-                scoute = 2;
-                break;
+        int scoute = 0;
 
-            default:
-                break;
-            }
+        switch ( objectType ) {
+        case MP2::OBJ_MINES:
+        case MP2::OBJ_ALCHEMYLAB:
+        case MP2::OBJ_SAWMILL:
+            scoute = 2;
+            break;
+
+        default:
+            break;
+        }
 
-            if ( scoute )
-                Maps::ClearFog( ( *it ).first, scoute, colors );
+        if ( scoute ) {
+            for ( const int32_t tileIndex : objectTiles.second ) {
+                Maps::ClearFog( tileIndex, scoute, colors );
+            }
         }
     }
 }
 
 void CapturedObjects::ResetColor( int color )
 {
-    for ( iterator it = begin(); it != end(); ++it ) {
-        ObjectColor & objcol = ( *it ).second.objcol;
-
-        if ( objcol.isColor( color ) ) {
-            const MP2::MapObjectType objectType = static_cast<MP2::MapObjectType>( objcol.first );
+    std::vector<int32_t> tiles;
 
-            objcol.second = objectType == MP2::OBJ_CASTLE ? Color::UNUSED : Color::NONE;
-            world.GetTiles( ( *it ).first ).CaptureFlags32( objectType, objcol.second );
+    for ( const auto & objectTiles : _objectTiles ) {
+        if ( static_cast<int>( objectTiles.first & 0xFFFF ) & color ) {
+            tiles.insert( tiles.end(), objectTiles.second.begin(), objectTiles.second.end() );
         }
     }
+
+    for ( const int32_t tileIndex : tiles ) {
+        CapturedObject & co = _objects[tileIndex];
+        const MP2::MapObjectType objectType = static_cast<MP2::MapObjectType>( co.objcol.first );
+
+        setObjectColor( tileIndex, co, ObjectColor( objectType, objectType == MP2::OBJ_CASTLE ? Color::UNUSED : Color::NONE ) );
+        world.GetTiles( tileIndex ).CaptureFlags32( objectType, co.objcol.second );
+        world.invalidateRadarTiles( tileIndex, 3 );
+    }
 }
 
 void CapturedObjects::tributeCapturedObjects( const int playerColorId, const int objectType, Funds & funds, int & objectCount )
@@ -310,19 +321,44 @@ void CapturedObjects::tributeCapturedObjects( const int playerColorId, const int
     funds = Funds();
     objectCount = 0;
 
-    for ( iterator it = begin(); it != end(); ++it ) {
-        const ObjectColor & objcol = ( *it ).second.objcol;
+    const std::set<int32_t> * tiles = getObjectTiles( objectType, playerColorId );
+    if ( tiles == nullptr ) {
+        return;
+    }
 
-        if ( objcol.isObject( objectType ) && objcol.isColor( playerColorId ) ) {
-            Maps::Tiles & tile = world.GetTiles( ( *it ).first );
+    for ( const int32_t tileIndex : *tiles ) {
+        Maps::Tiles & tile = world.GetTiles( tileIndex );
 
-            funds += Funds( tile.QuantityResourceCount() );
-            ++objectCount;
-            tile.QuantityReset();
-        }
+        funds += Funds( tile.QuantityResourceCount() );
+        ++objectCount;
+        tile.QuantityReset();
     }
 }
 
+void CapturedObjects::clear()
+{
+    _objects.clear();
+    _objectTiles.clear();
+}
+
+const std::set<int32_t> * CapturedObjects::getObjectTiles( const int objectType, const int color ) const
+{
+    const auto it = _objectTiles.find( getObjectColorKey( objectType, color ) );
+    return it != _objectTiles.end() && !it->second.empty() ? &it->second : nullptr;
+}
+
+void CapturedObjects::setObjectColor( const int32_t index, CapturedObject & object, const ObjectColor & objcol )
+{
+    if ( object.objcol == objcol ) {
+        return;
+    }
+
+    _objectTiles[getObjectColorKey( object.objcol.first, object.objcol.second )].erase( index );
+    _objectTiles[getObjectColorKey( objcol.first, objcol.second )].insert( index );
+
+    object.objcol = objcol;
+}
+
 World & world = World::Get();
 
 World & World::Get( void )
@@ -385,6 +421,21 @@ void World::Reset( void )
     heroes_cond_loss = Heroes::UNKNOWN;
 
     _seed = 0;
+
+    _tileArmyStrength.clear();
+    _fogDirections.clear();
+
+    _tilePassability.clear();
+    _tileObjectType.clear();
+    _tileGround.clear();
+    _tileFogColors.clear();
+    _tileRoad.clear();
+    _tileRegion.clear();
+
+    _radarChangedTiles.clear();
+    _isWholeRadarChanged = true;
+
+    ++_generation;
 }
 
 /* new maps */
@@ -431,6 +482,8 @@ void World::NewMaps( int32_t sw, int32_t sh )
 
         vec_tiles[i].Init( static_cast<int32_t>( i ), mp2tile );
     }
+
+    computeTileData();
 }
 
 void World::InitKingdoms( void )
@@ -970,12 +1023,19 @@ void World::CaptureObject( s32 index, int color )
     const MP2::MapObjectType objectType = GetTiles( index ).GetObject( false );
     map_captureobj.Set( index, objectType, color );
 
+    // Guardians of the captured object may be changed
+    resetTileArmyStrength( index );
+    invalidatePathfinder( index );
+
     Castle * castle = getCastleEntrance( Maps::GetPoint( index ) );
     if ( castle && castle->GetColor() != color )
         castle->ChangeColor( color );
 
     if ( color & ( Color::ALL | Color::UNUSED ) )
         GetTiles( index ).CaptureFlags32( objectType, color );
+
+    // Radar shows the color of the owner on all tiles of the object
+    invalidateRadarTiles( index, 3 );
 }
 
 /* return color captured object */
@@ -1303,13 +1363,13 @@ u32 World::GetUniq( void )
 
 uint32_t World::getDistance( const Heroes & hero, int targetIndex )
 {
-    _pathfinder.reEvaluateIfNeeded( hero );
+    _pathfinder.reEvaluateIfNeeded( hero, targetIndex );
     return _pathfinder.getDistance( targetIndex );
 }
 
 std::list<Route::Step> World::getPath( const Heroes & hero, int targetIndex )
 {
-    _pathfinder.reEvaluateIfNeeded( hero );
+    _pathfinder.reEvaluateIfNeeded( hero, targetIndex );
     return _pathfinder.buildPath( targetIndex );
 }
 
@@ -1319,6 +1379,188 @@ void World::resetPathfinder()
     AI::Get().resetPathfinder();
 }
 
+void World::invalidatePathfinder( const int32_t tileIndex )
+{
+    _pathfinder.invalidateTile( tileIndex );
+    AI::Get().invalidatePathfinder( tileIndex );
+}
+
+double World::getTileArmyStrength( const int32_t tileIndex )
+{
+    if ( _tileArmyStrength.size() != vec_tiles.size() ) {
+        _tileArmyStrength.assign( vec_tiles.size(), -1.0 );
+    }
+
+    double & strength = _tileArmyStrength[tileIndex];
+
+    if ( strength < 0 ) {
+        const Maps::Tiles & tile = vec_tiles[tileIndex];
+        const Heroes * hero = tile.GetObject() == MP2::OBJ_HEROES ? tile.GetHeroes() : nullptr;
+
+        strength = hero ? hero->GetArmy().GetStrength() : Army( tile ).GetStrength();
+    }
+
+    return strength;
+}
+
+void World::resetTileArmyStrength( const int32_t tileIndex )
+{
+    if ( tileIndex >= 0 && static_cast<size_t>( tileIndex ) < _tileArmyStrength.size() ) {
+        _tileArmyStrength[tileIndex] = -1.0;
+    }
+}
+
+void World::resetTileArmyStrengthCache()
+{
+    _tileArmyStrength.clear();
+}
+
+int World::getFogDirections( const int32_t tileIndex, const int colors )
+{
+    if ( _fogDirections.size() != vec_tiles.size() * KINGDOMMAX ) {
+        computeFogDirections();
+    }
+
+    // A direction is covered by fog for a union of colors only if it is covered by fog for every color of the union
+    int directions = DIRECTION_ALL;
+
+    const uint16_t * tileDirections = &_fogDirections[static_cast<size_t>( tileIndex ) * KINGDOMMAX];
+    for ( int colorIndex = 0; colorIndex < KINGDOMMAX; ++colorIndex ) {
+        if ( colors & ( 1 << colorIndex ) ) {
+            directions &= tileDirections[colorIndex];
+        }
+    }
+
+    return directions;
+}
+
+void World::updateFogDirections( const int32_t tileIndex, const int colors )
+{
+    // Fog directions will be calculated from scratch when requested
+    if ( _fogDirections.empty() ) {
+        return;
+    }
+
+    const Directions & directions = Direction::All();
+
+    for ( int colorIndex = 0; colorIndex < KINGDOMMAX; ++colorIndex ) {
+        if ( ( colors & ( 1 << colorIndex ) ) == 0 ) {
+            continue;
+        }
+
+        _fogDirections[static_cast<size_t>( tileIndex ) * KINGDOMMAX + colorIndex] &= ~Direction::CENTER;
+
+        for ( const int direction : directions ) {
+            if ( Maps::isValidDirection( tileIndex, direction ) ) {
+                const int32_t neighbourIndex = Maps::GetDirectionIndex( tileIndex, direction );
+                _fogDirections[static_cast<size_t>( neighbourIndex ) * KINGDOMMAX + colorIndex] &= ~Direction::Reflect( direction );
+            }
+        }
+    }
+}
+
+void World::invalidateRadarTiles( const int32_t tileIndex, const int32_t distance )
+{
+    if ( _isWholeRadarChanged ) {
+        return;
+    }
+
+    // Radar is not updated during the turns of other players, it is faster to update it as a whole than to track all their changes
+    if ( _radarChangedTiles.size() > vec_tiles.size() / 8 ) {
+        _radarChangedTiles.clear();
+        _isWholeRadarChanged = true;
+        return;
+    }
+
+    const fheroes2::Point center = Maps::GetPoint( tileIndex );
+
+    for ( int32_t y = std::max( center.y - distance, 0 ); y <= std::min( center.y + distance, height - 1 ); ++y ) {
+        for ( int32_t x = std::max( center.x - distance, 0 ); x <= std::min( center.x + distance, width - 1 ); ++x ) {
+            _radarChangedTiles.push_back( y * width + x );
+        }
+    }
+}
+
+bool World::takeRadarChangedTiles( std::vector<int32_t> & tiles )
+{
+    tiles.clear();
+    std::swap( tiles, _radarChangedTiles );
+
+    const bool isWholeRadarChanged = _isWholeRadarChanged;
+    _isWholeRadarChanged = false;
+
+    return !isWholeRadarChanged;
+}
+
+void World::updateTileData( const Maps::Tiles & tile )
+{
+    const size_t tileIndex = static_cast<size_t>( tile.GetIndex() );
+
+    // Tiles are changed while the map is being loaded, all the data is computed at once afterwards. Copies of tiles are not a part of the world.
+    if ( _tilePassability.size() != vec_tiles.size() || tileIndex >= vec_tiles.size() || &vec_tiles[tileIndex] != &tile ) {
+        return;
+    }
+
+    _tilePassability[tileIndex] = tile.GetPassable();
+    _tileObjectType[tileIndex] = tile.GetObject();
+    _tileGround[tileIndex] = static_cast<uint16_t>( tile.GetGround() );
+    _tileFogColors[tileIndex] = tile.getFogColors();
+    _tileRoad[tileIndex] = tile.isRoad() ? 1 : 0;
+    _tileRegion[tileIndex] = tile.GetRegion();
+}
+
+void World::computeTileData()
+{
+    const size_t tileCount = vec_tiles.size();
+
+    _tilePassability.resize( tileCount );
+    _tileObjectType.resize( tileCount );
+    _tileGround.resize( tileCount );
+    _tileFogColors.resize( tileCount );
+    _tileRoad.resize( tileCount );
+    _tileRegion.resize( tileCount );
+
+    for ( const Maps::Tiles & tile : vec_tiles ) {
+        updateTileData( tile );
+    }
+}
+
+void World::computeFogDirections()
+{
+    _fogDirections.assign( vec_tiles.size() * KINGDOMMAX, 0 );
+
+    const Directions & directions = Direction::All();
+
+    for ( const Maps::Tiles & tile : vec_tiles ) {
+        const int32_t tileIndex = tile.GetIndex();
+        uint16_t * tileDirections = &_fogDirections[static_cast<size_t>( tileIndex ) * KINGDOMMAX];
+
+        for ( int colorIndex = 0; colorIndex < KINGDOMMAX; ++colorIndex ) {
+            const int color = 1 << colorIndex;
+            int fogDirections = tile.isFog( color ) ? Direction::CENTER : Direction::UNKNOWN;
+
+            for ( const int direction : directions ) {
+                if ( !Maps::isValidDirection( tileIndex, direction ) || vec_tiles[Maps::GetDirectionIndex( tileIndex, direction )].isFog( color ) ) {
+                    fogDirections |= direction;
+                }
+            }
+
+            tileDirections[colorIndex] = static_cast<uint16_t>( fogDirections );
+        }
+    }
+}
+
+void World::updateTileArmyStrengthCache()
+{
+    for ( const Maps::Tiles & tile : vec_tiles ) {
+        const MP2::MapObjectType objectType = tile.GetObject();
+
+        if ( objectType == MP2::OBJ_HEROES || MP2::isProtectedObject( objectType ) ) {
+            getTileArmyStrength( tile.GetIndex() );
+        }
+    }
+}
+
 void World::PostLoad( const bool setTilePassabilities )
 {
     if ( setTilePassabilities ) {
@@ -1349,6 +1591,16 @@ void World::PostLoad( const bool setTilePassabilities )
     }
 
     resetPathfinder();
+    resetTileArmyStrengthCache();
+    _fogDirections.clear();
+
+    _radarChangedTiles.clear();
+    _isWholeRadarChanged = true;
+
+    ++_generation;
+
+    computeTileData();
+
     ComputeStaticAnalysis();
 }
 
@@ -1376,6 +1628,43 @@ StreamBase & operator>>( StreamBase & msg, CapturedObject & obj )
     return msg >> obj.objcol >> obj.guardians >> obj.split;
 }
 
+StreamBase & operator<<( StreamBase & msg, const CapturedObjects & objs )
+{
+    // Objects are written in the order of their tiles, the same way as they used to be written by std::map
+    std::vector<int32_t> tiles;
+    tiles.reserve( objs._objects.size() );
+
+    for ( const auto & object : objs._objects ) {
+        tiles.push_back( object.first );
+    }
+
+    std::sort( tiles.begin(), tiles.end() );
+
+    msg.put32( static_cast<u32>( tiles.size() ) );
+    for ( const int32_t tileIndex : tiles ) {
+        msg << tileIndex << objs._objects.at( tileIndex );
+    }
+
+    return msg;
+}
+
+StreamBase & operator>>( StreamBase & msg, CapturedObjects & objs )
+{
+    objs.clear();
+
+    const u32 size = msg.get32();
+    for ( u32 i = 0; i < size; ++i ) {
+        int32_t tileIndex = 0;
+        CapturedObject object;
+        msg >> tileIndex >> object;
+
+        objs._objectTiles[CapturedObjects::getObjectColorKey( object.GetObject(), object.GetColor() )].insert( tileIndex );
+        objs._objects[tileIndex] = object;
+    }
+
+    return msg;
+}
+
 StreamBase & operator<<( StreamBase & msg, const MapObjects & objs )
 {
     msg << static_cast<u32>( objs.size() );
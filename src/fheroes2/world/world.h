@@ -24,11 +24,14 @@
 #define H2WORLD_H
 
 #include <map>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "artifact_ultimate.h"
 #include "castle_heroes.h"
+#include "ground.h"
 #include "kingdom.h"
 #include "maps.h"
 #include "maps_tiles.h"
@@ -76,7 +79,6 @@ using MapActions = std::map<s32, ListActions>;
 
 struct CapturedObject
 {
-    ObjectColor objcol;
     Troop guardians;
     int split;
 
@@ -88,6 +90,10 @@ struct CapturedObject
     {
         return split;
     }
+    int GetObject( void ) const
+    {
+        return objcol.first;
+    }
     int GetColor( void ) const
     {
         return objcol.second;
@@ -97,22 +103,25 @@ struct CapturedObject
         return guardians;
     }
 
-    void Set( int obj, int col )
-    {
-        objcol = ObjectColor( obj, col );
-    }
-    void SetColor( int col )
-    {
-        objcol.second = col;
-    }
     void SetSplit( int spl )
     {
         split = spl;
     }
+
+private:
+    // Type and color are changed only by CapturedObjects which keeps the tiles of the objects of every type and color
+    friend class CapturedObjects;
+    friend StreamBase & operator<<( StreamBase &, const CapturedObject & );
+    friend StreamBase & operator>>( StreamBase &, CapturedObject & );
+
+    ObjectColor objcol;
 };
 
-struct CapturedObjects : std::map<s32, CapturedObject>
+// Captured objects by their tile index. Tiles of the objects of every type and color are also tracked separately, so objects
+// of a certain type and color can be counted or processed without scanning all the captured objects of the map.
+class CapturedObjects
 {
+public:
     void Set( s32, int, int );
     void SetColor( s32, int );
     void ClearFog( int );
@@ -125,6 +134,26 @@ struct CapturedObjects : std::map<s32, CapturedObject>
     u32 GetCount( int, int ) const;
     u32 GetCountMines( int, int ) const;
     int GetColor( s32 ) const;
+
+    void clear();
+
+private:
+    friend StreamBase & operator<<( StreamBase &, const CapturedObjects & );
+    friend StreamBase & operator>>( StreamBase &, CapturedObjects & );
+
+    static uint32_t getObjectColorKey( const int objectType, const int color )
+    {
+        return ( static_cast<uint32_t>( objectType ) << 16 ) | static_cast<uint16_t>( color );
+    }
+
+    // Returns the tiles of the captured objects of the given type and color or nullptr if there are no such objects
+    const std::set<int32_t> * getObjectTiles( const int objectType, const int color ) const;
+
+    // Changes the type and color of the captured object on the given tile keeping the tiles of the objects up to date
+    void setObjectColor( const int32_t index, CapturedObject & object, const ObjectColor & objcol );
+
+    std::unordered_map<int32_t, CapturedObject> _objects;
+    std::unordered_map<uint32_t, std::set<int32_t>> _objectTiles;
 };
 
 struct EventDate
@@ -295,9 +324,84 @@ public:
     const MapRegion & getRegion( size_t id ) const;
     size_t getRegionCount() const;
 
+    // Returns the lower bound of the movement cost between the regions of the given tiles for an army without movement points (like
+    // a castle garrison or a monster). Only the terrain, teleports and the passability of the tiles at the time of the static analysis
+    // are taken into account, objects which can be removed from the map are ignored. Returns 0 if the regions are unknown and UINT32_MAX
+    // if there is no path between the regions.
+    uint32_t getRegionDistance( const int32_t fromIndex, const int32_t toIndex ) const;
+
     uint32_t getDistance( const Heroes & hero, int targetIndex );
     std::list<Route::Step> getPath( const Heroes & hero, int targetIndex );
     void resetPathfinder();
+    // Paths passing through or near the given tile will be re-evaluated by all pathfinders
+    void invalidatePathfinder( const int32_t tileIndex );
+
+    // Returns the strength of the army on the given tile: the army of the hero standing on this tile or the army guarding the object
+    // (monsters, guardians of captured objects, etc). The value is memoized until the object on this tile changes or the cache is reset.
+    double getTileArmyStrength( const int32_t tileIndex );
+    void resetTileArmyStrength( const int32_t tileIndex );
+    void resetTileArmyStrengthCache();
+
+    // Calculates memoized values for all the tiles which may be queried by the AI pathfinder (heroes and protected objects),
+    // after this call getTileArmyStrength() doesn't modify the world for these tiles.
+    void updateTileArmyStrengthCache();
+
+    // Returns the directions from the given tile (including Direction::CENTER for the tile itself) to the tiles which are covered by fog
+    // for all the given colors. Directions leading outside of the map are considered to be covered by fog. The values are memoized
+    // for every color and are kept up to date by updateFogDirections().
+    int getFogDirections( const int32_t tileIndex, const int colors );
+
+    // Must be called when fog has been cleared on the given tile for the given colors
+    void updateFogDirections( const int32_t tileIndex, const int colors );
+
+    // Marks the tiles within the given distance from the given tile as changed for the radar. Has to be called when the object,
+    // its owner or fog is changed on these tiles.
+    void invalidateRadarTiles( const int32_t tileIndex, const int32_t distance = 0 );
+
+    // Moves the indexes of the tiles changed since the previous call to the given vector. Returns false if there are too many
+    // changed tiles to track them separately, in this case the whole radar has to be updated.
+    bool takeRadarChangedTiles( std::vector<int32_t> & tiles );
+
+    // The following methods return copies of the tile fields most frequently read by the pathfinders and the static analysis. They are
+    // stored in separate arrays, so reading them doesn't load whole tiles. The values are kept up to date by updateTileData().
+    uint16_t getTilePassability( const int32_t tileIndex ) const
+    {
+        return _tilePassability[tileIndex];
+    }
+
+    // Same as Maps::Tiles::GetObject()
+    MP2::MapObjectType getTileObjectType( const int32_t tileIndex ) const
+    {
+        return _tileObjectType[tileIndex];
+    }
+
+    int getTileGround( const int32_t tileIndex ) const
+    {
+        return _tileGround[tileIndex];
+    }
+
+    bool isWaterTile( const int32_t tileIndex ) const
+    {
+        return _tileGround[tileIndex] == Maps::Ground::WATER;
+    }
+
+    bool isRoadTile( const int32_t tileIndex ) const
+    {
+        return _tileRoad[tileIndex] != 0;
+    }
+
+    bool isFogTile( const int32_t tileIndex, const int colors ) const
+    {
+        return ( _tileFogColors[tileIndex] & colors ) == colors;
+    }
+
+    uint32_t getTileRegion( const int32_t tileIndex ) const
+    {
+        return _tileRegion[tileIndex];
+    }
+
+    // Must be called when the passability, object, fog or region of the given tile has been changed
+    void updateTileData( const Maps::Tiles & tile );
 
     void ComputeStaticAnalysis();
     static u32 GetUniq( void );
@@ -305,6 +409,12 @@ public:
     uint32_t GetMapSeed() const;
     uint32_t GetWeekSeed() const;
 
+    // Changes every time a new map is created or a saved game is loaded, so the data kept outside of the world can be invalidated
+    uint32_t getGeneration() const
+    {
+        return _generation;
+    }
+
     bool isAnyKingdomVisited( const MP2::MapObjectType objectType, const int32_t dstIndex ) const;
 
 private:
@@ -318,6 +428,13 @@ private:
 
     bool isValidCastleEntrance( const fheroes2::Point & tilePosition ) const;
 
+    // Calculates distances between all the regions using an abstract graph built on top of the regions
+    void computeRegionDistances();
+
+    void computeFogDirections();
+
+    void computeTileData();
+
     friend class Radar;
     friend StreamBase & operator<<( StreamBase &, const World & );
     friend StreamBase & operator>>( StreamBase &, World & );
@@ -352,12 +469,37 @@ private:
     std::map<uint8_t, Maps::Indexes> _allWhirlpools; // All indexes of tiles that contain a certain part (sprite index) of the whirlpool
 
     std::vector<MapRegion> _regions;
+    // Lower bounds of the movement costs between every pair of regions, see getRegionDistance()
+    std::vector<uint32_t> _regionDistances;
     PlayerWorldPathfinder _pathfinder;
+
+    // Memoized army strength for every tile, negative values stand for values which are not calculated yet
+    std::vector<double> _tileArmyStrength;
+
+    // Memoized fog directions for every tile and every color, KINGDOMMAX values per tile, see getFogDirections()
+    std::vector<uint16_t> _fogDirections;
+
+    // Copies of the tile fields, see getTilePassability() and the following methods
+    std::vector<uint16_t> _tilePassability;
+    std::vector<MP2::MapObjectType> _tileObjectType;
+    std::vector<uint16_t> _tileGround;
+    std::vector<uint8_t> _tileFogColors;
+    std::vector<uint8_t> _tileRoad;
+    std::vector<uint32_t> _tileRegion;
+
+    // Tiles changed for the radar, see takeRadarChangedTiles()
+    std::vector<int32_t> _radarChangedTiles;
+    bool _isWholeRadarChanged = true;
+
+    uint32_t _generation = 0;
 };
 
 StreamBase & operator<<( StreamBase &, const CapturedObject & );
 StreamBase & operator>>( StreamBase &, CapturedObject & );
 
+StreamBase & operator<<( StreamBase &, const CapturedObjects & );
+StreamBase & operator>>( StreamBase &, CapturedObjects & );
+
 StreamBase & operator<<( StreamBase &, const World & );
 StreamBase & operator>>( StreamBase &, World & );
 
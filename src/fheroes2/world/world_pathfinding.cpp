@@ -18,6 +18,7 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <set>
@@ -33,9 +34,8 @@ namespace
 {
     bool isTileBlocked( int tileIndex, bool fromWater )
     {
-        const Maps::Tiles & tile = world.GetTiles( tileIndex );
-        const bool toWater = tile.isWater();
-        const MP2::MapObjectType objectType = tile.GetObject();
+        const bool toWater = world.isWaterTile( tileIndex );
+        const MP2::MapObjectType objectType = world.getTileObjectType( tileIndex );
 
         if ( objectType == MP2::OBJ_HEROES || objectType == MP2::OBJ_MONSTER || objectType == MP2::OBJ_BOAT )
             return true;
@@ -51,8 +51,14 @@ namespace
 
     bool isTileBlockedForAIWithArmy( int tileIndex, int color, double armyStrength )
     {
+        const MP2::MapObjectType objectType = world.getTileObjectType( tileIndex );
+
+        // Most of the tiles don't contain objects, the rest of the tile data is not needed for them
+        if ( objectType == MP2::OBJ_ZERO ) {
+            return false;
+        }
+
         const Maps::Tiles & tile = world.GetTiles( tileIndex );
-        const MP2::MapObjectType objectType = tile.GetObject();
 
         // Special cases: check if we can defeat the Hero/Monster and pass through
         if ( objectType == MP2::OBJ_HEROES ) {
@@ -62,12 +68,12 @@ namespace
                     return true;
                 }
 
-                return otherHero->GetArmy().GetStrength() > armyStrength;
+                return world.getTileArmyStrength( tileIndex ) > armyStrength;
             }
         }
 
         if ( objectType == MP2::OBJ_MONSTER || ( objectType == MP2::OBJ_ARTIFACT && tile.QuantityVariant() > 5 ) )
-            return Army( tile ).GetStrength() > armyStrength;
+            return world.getTileArmyStrength( tileIndex ) > armyStrength;
 
         // check if AI has the key for the barrier
         if ( objectType == MP2::OBJ_BARRIER && world.GetKingdom( color ).IsVisitTravelersTent( tile.QuantityColor() ) )
@@ -83,8 +89,7 @@ namespace
 
     bool isValidPath( const int index, const int direction, const int heroColor )
     {
-        const Maps::Tiles & fromTile = world.GetTiles( index );
-        const bool fromWater = fromTile.isWater();
+        const bool fromWater = world.isWaterTile( index );
 
         // check corner water/coast
         if ( fromWater ) {
@@ -92,7 +97,7 @@ namespace
             switch ( direction ) {
             case Direction::TOP_LEFT: {
                 assert( index >= mapWidth + 1 );
-                if ( world.GetTiles( index - mapWidth - 1 ).isWater() && ( !world.GetTiles( index - 1 ).isWater() || !world.GetTiles( index - mapWidth ).isWater() ) ) {
+                if ( world.isWaterTile( index - mapWidth - 1 ) && ( !world.isWaterTile( index - 1 ) || !world.isWaterTile( index - mapWidth ) ) ) {
                     // Cannot sail through the corner of land.
                     return false;
                 }
@@ -101,7 +106,7 @@ namespace
             }
             case Direction::TOP_RIGHT: {
                 assert( index >= mapWidth && index + 1 < mapWidth * world.h() );
-                if ( world.GetTiles( index - mapWidth + 1 ).isWater() && ( !world.GetTiles( index + 1 ).isWater() || !world.GetTiles( index - mapWidth ).isWater() ) ) {
+                if ( world.isWaterTile( index - mapWidth + 1 ) && ( !world.isWaterTile( index + 1 ) || !world.isWaterTile( index - mapWidth ) ) ) {
                     // Cannot sail through the corner of land.
                     return false;
                 }
@@ -110,7 +115,7 @@ namespace
             }
             case Direction::BOTTOM_RIGHT: {
                 assert( index + mapWidth + 1 < mapWidth * world.h() );
-                if ( world.GetTiles( index + mapWidth + 1 ).isWater() && ( !world.GetTiles( index + 1 ).isWater() || !world.GetTiles( index + mapWidth ).isWater() ) ) {
+                if ( world.isWaterTile( index + mapWidth + 1 ) && ( !world.isWaterTile( index + 1 ) || !world.isWaterTile( index + mapWidth ) ) ) {
                     // Cannot sail through the corner of land.
                     return false;
                 }
@@ -119,7 +124,7 @@ namespace
             }
             case Direction::BOTTOM_LEFT: {
                 assert( index >= 1 && index + mapWidth - 1 < mapWidth * world.h() );
-                if ( world.GetTiles( index + mapWidth - 1 ).isWater() && ( !world.GetTiles( index - 1 ).isWater() || !world.GetTiles( index + mapWidth ).isWater() ) ) {
+                if ( world.isWaterTile( index + mapWidth - 1 ) && ( !world.isWaterTile( index - 1 ) || !world.isWaterTile( index + mapWidth ) ) ) {
                     // Cannot sail through the corner of land.
                     return false;
                 }
@@ -131,12 +136,18 @@ namespace
             }
         }
 
-        if ( !fromTile.isPassableTo( direction ) ) {
+        if ( ( world.getTilePassability( index ) & direction ) == 0 ) {
             return false;
         }
 
-        const Maps::Tiles & toTile = world.GetTiles( Maps::GetDirectionIndex( index, direction ) );
-        return toTile.isPassableFrom( Direction::Reflect( direction ), fromWater, false, heroColor );
+        // Same as Maps::Tiles::isPassableFrom()
+        const int32_t toIndex = Maps::GetDirectionIndex( index, direction );
+        if ( world.isFogTile( toIndex, heroColor ) ) {
+            return false;
+        }
+
+        return Maps::Tiles::isPassableFrom( Direction::Reflect( direction ), fromWater, world.isWaterTile( toIndex ), world.getTileObjectType( toIndex ),
+                                            world.getTilePassability( toIndex ) );
     }
 }
 
@@ -153,7 +164,28 @@ void WorldPathfinder::checkWorldSize()
         for ( size_t i = 0; i < directions.size(); ++i ) {
             _mapOffset[i] = Maps::GetDirectionIndex( 0, directions[i] );
         }
+
+        _settledNodes.clear();
+        _searchTarget = -1;
+        _isWholeMapProcessed = false;
+        _changedTiles.clear();
+    }
+}
+
+void WorldPathfinder::invalidateTile( const int tileIndex )
+{
+    // Nothing has been evaluated yet or the whole map is going to be processed anyway
+    if ( _pathStart == -1 ) {
+        return;
     }
+
+    // After a lot of changes it is cheaper to process the whole map again than to repair the previous results
+    if ( _changedTiles.size() >= _cache.size() / 16 ) {
+        reset();
+        return;
+    }
+
+    _changedTiles.push_back( tileIndex );
 }
 
 uint32_t WorldPathfinder::calculatePathPenalty( const std::list<Route::Step> & path )
@@ -167,10 +199,9 @@ uint32_t WorldPathfinder::calculatePathPenalty( const std::list<Route::Step> & p
 
 uint32_t WorldPathfinder::getMovementPenalty( int src, int dst, int direction ) const
 {
-    const Maps::Tiles & srcTile = world.GetTiles( src );
-    const Maps::Tiles & dstTile = world.GetTiles( dst );
+    const bool isSrcTileRoad = world.isRoadTile( src );
 
-    uint32_t penalty = srcTile.isRoad() && dstTile.isRoad() ? Maps::Ground::roadPenalty : Maps::Ground::GetPenalty( srcTile, _pathfindingSkill );
+    uint32_t penalty = isSrcTileRoad && world.isRoadTile( dst ) ? Maps::Ground::roadPenalty : Maps::Ground::GetPenalty( world.getTileGround( src ), _pathfindingSkill );
 
     // Diagonal movement costs 50% more
     if ( Direction::isDiagonal( direction ) ) {
@@ -188,7 +219,7 @@ uint32_t WorldPathfinder::getMovementPenalty( int src, int dst, int direction )
         assert( src == _pathStart || node._from != -1 );
 
         const uint32_t remainingMovePoints = node._remainingMovePoints;
-        const uint32_t srcTilePenalty = srcTile.isRoad() ? Maps::Ground::roadPenalty : Maps::Ground::GetPenalty( srcTile, _pathfindingSkill );
+        const uint32_t srcTilePenalty = isSrcTileRoad ? Maps::Ground::roadPenalty : Maps::Ground::GetPenalty( world.getTileGround( src ), _pathfindingSkill );
 
         // If we still have enough movement points to move over the src tile in the straight
         // direction, but not enough to move to the dst tile, then the "last move" logic is
@@ -221,7 +252,151 @@ uint32_t WorldPathfinder::substractMovePoints( const uint32_t movePoints, const
     return movePoints - substractedMovePoints;
 }
 
-void WorldPathfinder::processWorldMap()
+void WorldPathfinder::processWorldMap( const int targetIndex /* = -1 */ )
+{
+    NodeQueue nodesToExplore;
+    initializeSearch( nodesToExplore, targetIndex );
+
+    for ( int currentNodeIdx = settleNextNode( nodesToExplore ); currentNodeIdx != -1; currentNodeIdx = settleNextNode( nodesToExplore ) ) {
+        // The cost of the path to the target node is final, there is no need to process the rest of the map
+        if ( currentNodeIdx == targetIndex ) {
+            return;
+        }
+
+        processCurrentNode( nodesToExplore, currentNodeIdx );
+    }
+
+    _isWholeMapProcessed = true;
+}
+
+void WorldPathfinder::processWorldMap( const std::vector<int> & targets, const uint32_t costLimit )
+{
+    std::set<int> remainingTargets( targets.begin(), targets.end() );
+
+    NodeQueue nodesToExplore;
+    initializeSearch( nodesToExplore, -1 );
+
+    for ( int currentNodeIdx = settleNextNode( nodesToExplore ); currentNodeIdx != -1; currentNodeIdx = settleNextNode( nodesToExplore ) ) {
+        // Nodes are settled in the order of increasing cost, all the remaining nodes are even further away
+        if ( costLimit > 0 && _cache[currentNodeIdx]._cost > costLimit ) {
+            // This node has not been processed, so we cannot be sure that it is even reachable
+            _settledNodes[currentNodeIdx] = 0;
+
+            return;
+        }
+
+        // The node has to be processed even if it is the last target, because the processing may find out that this node is not reachable
+        processCurrentNode( nodesToExplore, currentNodeIdx );
+
+        if ( remainingTargets.erase( currentNodeIdx ) > 0 && remainingTargets.empty() ) {
+            return;
+        }
+    }
+
+    _isWholeMapProcessed = true;
+}
+
+void WorldPathfinder::repairWorldMap()
+{
+    assert( _isWholeMapProcessed );
+
+    if ( _changedTiles.empty() ) {
+        return;
+    }
+
+    const Directions & directions = Direction::All();
+    const int worldSize = static_cast<int>( _cache.size() );
+
+    // State of every node: 0 - unknown yet, 1 - the path to this node has to be evaluated again, 2 - the path to this node is still valid
+    std::vector<uint8_t> nodeStates( _cache.size(), 0 );
+
+    // The passability of a tile depends on the adjacent tiles as well (e.g. monsters protecting the tile), so the processing of all the
+    // adjacent nodes may have a different outcome now
+    for ( const int tileIndex : _changedTiles ) {
+        nodeStates[tileIndex] = 1;
+
+        for ( size_t i = 0; i < directions.size(); ++i ) {
+            if ( Maps::isValidDirection( tileIndex, directions[i] ) ) {
+                nodeStates[tileIndex + _mapOffset[i]] = 1;
+            }
+        }
+    }
+
+    // The path to the starting node never changes
+    nodeStates[_pathStart] = 2;
+
+    // The path to the node also has to be evaluated again if it goes through any of the affected nodes
+    std::vector<int> pathNodes;
+
+    for ( int nodeIdx = 0; nodeIdx < worldSize; ++nodeIdx ) {
+        int currentNodeIdx = nodeIdx;
+
+        while ( nodeStates[currentNodeIdx] == 0 ) {
+            const int fromIdx = _cache[currentNodeIdx]._from;
+            if ( fromIdx == -1 ) {
+                nodeStates[currentNodeIdx] = 2;
+                break;
+            }
+
+            assert( pathNodes.size() < _cache.size() );
+
+            pathNodes.push_back( currentNodeIdx );
+            currentNodeIdx = fromIdx;
+        }
+
+        for ( const int pathNodeIdx : pathNodes ) {
+            nodeStates[pathNodeIdx] = nodeStates[currentNodeIdx];
+        }
+
+        pathNodes.clear();
+    }
+
+    for ( int nodeIdx = 0; nodeIdx < worldSize; ++nodeIdx ) {
+        if ( nodeStates[nodeIdx] != 1 ) {
+            continue;
+        }
+
+        // Teleports connect tiles far away from each other, so it is not easy to find out which nodes are affected. Just process the
+        // whole map again.
+        const MP2::MapObjectType objectType = world.GetTiles( nodeIdx ).GetObject( false );
+        if ( objectType == MP2::OBJ_STONELITHS || objectType == MP2::OBJ_WHIRLPOOL ) {
+            processWorldMap();
+            return;
+        }
+
+        _cache[nodeIdx].resetNode();
+        _settledNodes[nodeIdx] = 0;
+    }
+
+    _changedTiles.clear();
+    _searchTarget = -1;
+    _isRepairing = true;
+
+    NodeQueue nodesToExplore;
+
+    // The affected nodes can be reached from the adjacent nodes whose paths are still valid. These nodes are processed once again to put
+    // their neighbours to the queue.
+    for ( int nodeIdx = 0; nodeIdx < worldSize; ++nodeIdx ) {
+        if ( nodeStates[nodeIdx] != 2 || !_settledNodes[nodeIdx] ) {
+            continue;
+        }
+
+        for ( size_t i = 0; i < directions.size(); ++i ) {
+            if ( Maps::isValidDirection( nodeIdx, directions[i] ) && nodeStates[nodeIdx + _mapOffset[i]] == 1 ) {
+                processCurrentNode( nodesToExplore, nodeIdx );
+                break;
+            }
+        }
+    }
+
+    for ( int currentNodeIdx = settleNextNode( nodesToExplore ); currentNodeIdx != -1; currentNodeIdx = settleNextNode( nodesToExplore ) ) {
+        processCurrentNode( nodesToExplore, currentNodeIdx );
+    }
+
+    _isRepairing = false;
+}
+
+void WorldPathfinder::initializeSearch( NodeQueue & nodesToExplore, const int targetIndex )
 {
     // reset cache back to default value
     for ( size_t idx = 0; idx < _cache.size(); ++idx ) {
@@ -229,15 +404,34 @@ void WorldPathfinder::processWorldMap()
     }
     _cache[_pathStart] = WorldNode( -1, 0, MP2::MapObjectType::OBJ_ZERO, _remainingMovePoints );
 
-    std::vector<int> nodesToExplore;
-    nodesToExplore.push_back( _pathStart );
+    _settledNodes.assign( _cache.size(), 0 );
+    _searchTarget = targetIndex;
+    _isWholeMapProcessed = false;
+    _changedTiles.clear();
 
-    for ( size_t lastProcessedNode = 0; lastProcessedNode < nodesToExplore.size(); ++lastProcessedNode ) {
-        processCurrentNode( nodesToExplore, nodesToExplore[lastProcessedNode] );
+    addNodeToExplore( nodesToExplore, _pathStart );
+}
+
+int WorldPathfinder::settleNextNode( NodeQueue & nodesToExplore )
+{
+    while ( !nodesToExplore.empty() ) {
+        const int nodeIdx = nodesToExplore.top().second;
+        nodesToExplore.pop();
+
+        // Outdated entry, this node has already been processed with a lower cost
+        if ( _settledNodes[nodeIdx] ) {
+            continue;
+        }
+
+        _settledNodes[nodeIdx] = 1;
+
+        return nodeIdx;
     }
+
+    return -1;
 }
 
-void WorldPathfinder::checkAdjacentNodes( std::vector<int> & nodesToExplore, int currentNodeIdx )
+void WorldPathfinder::checkAdjacentNodes( NodeQueue & nodesToExplore, int currentNodeIdx )
 {
     const Directions & directions = Direction::All();
     const WorldNode & currentNode = _cache[currentNodeIdx];
@@ -245,7 +439,7 @@ void WorldPathfinder::checkAdjacentNodes( std::vector<int> & nodesToExplore, int
     for ( size_t i = 0; i < directions.size(); ++i ) {
         if ( Maps::isValidDirection( currentNodeIdx, directions[i] ) ) {
             const int newIndex = currentNodeIdx + _mapOffset[i];
-            if ( newIndex == _pathStart )
+            if ( newIndex == _pathStart || ( _settledNodes[newIndex] && !_isRepairing ) )
                 continue;
 
             const uint32_t movementPenalty = getMovementPenalty( currentNodeIdx, newIndex, directions[i] );
@@ -254,20 +448,42 @@ void WorldPathfinder::checkAdjacentNodes( std::vector<int> & nodesToExplore, int
 
             WorldNode & newNode = _cache[newIndex];
 
-            if ( isValidPath( currentNodeIdx, directions[i], _currentColor ) && ( newNode._from == -1 || newNode._cost > moveCost ) ) {
-                const Maps::Tiles & tile = world.GetTiles( newIndex );
-
+            if ( isValidPath( currentNodeIdx, directions[i], _currentColor ) && isBetterPath( newIndex, moveCost ) ) {
                 newNode._from = currentNodeIdx;
                 newNode._cost = moveCost;
-                newNode._objectID = tile.GetObject();
+                newNode._objectID = world.getTileObjectType( newIndex );
                 newNode._remainingMovePoints = remainingMovePoints;
+                _settledNodes[newIndex] = 0;
 
-                nodesToExplore.push_back( newIndex );
+                addNodeToExplore( nodesToExplore, newIndex );
             }
         }
     }
 }
 
+void WorldPathfinder::addNodeToExplore( NodeQueue & nodesToExplore, int nodeIdx ) const
+{
+    uint32_t priority = _cache[nodeIdx]._cost;
+    if ( _searchTarget != -1 ) {
+        priority += getCostEstimate( nodeIdx, _searchTarget );
+    }
+
+    nodesToExplore.emplace( priority, nodeIdx );
+}
+
+bool WorldPathfinder::isBetterPath( const int nodeIdx, const uint32_t cost ) const
+{
+    const WorldNode & node = _cache[nodeIdx];
+
+    if ( _settledNodes[nodeIdx] ) {
+        // The cost of the node is final unless the previous results are being repaired after the map has been changed: a cheaper path
+        // through the changed tiles may appear. The nodes which turned out to be not accessible remain so.
+        return _isRepairing && node._from != -1 && node._cost > cost;
+    }
+
+    return node._from == -1 || node._cost > cost;
+}
+
 void PlayerWorldPathfinder::reset()
 {
     WorldPathfinder::checkWorldSize();
@@ -280,6 +496,8 @@ void PlayerWorldPathfinder::reset()
         _remainingMovePoints = 0;
         _maxMovePoints = 0;
     }
+
+    _changedTiles.clear();
 }
 
 void PlayerWorldPathfinder::reEvaluateIfNeeded( const Heroes & hero )
@@ -293,6 +511,35 @@ void PlayerWorldPathfinder::reEvaluateIfNeeded( const Heroes & hero )
 
         processWorldMap();
     }
+    else if ( !_isWholeMapProcessed ) {
+        // The previous search was goal-directed, only a part of the map was processed
+        processWorldMap();
+    }
+    else {
+        repairWorldMap();
+    }
+}
+
+void PlayerWorldPathfinder::reEvaluateIfNeeded( const Heroes & hero, const int targetIndex )
+{
+    assert( targetIndex != -1 );
+
+    auto currentSettings = std::forward_as_tuple( _pathStart, _pathfindingSkill, _currentColor, _remainingMovePoints, _maxMovePoints );
+    const auto newSettings = std::make_tuple( hero.GetIndex(), static_cast<uint8_t>( hero.GetLevelSkill( Skill::Secondary::PATHFINDING ) ), hero.GetColor(),
+                                              hero.GetMovePoints(), hero.GetMaxMovePoints() );
+
+    if ( currentSettings != newSettings ) {
+        currentSettings = newSettings;
+
+        processWorldMap( targetIndex );
+    }
+    else if ( _isWholeMapProcessed ) {
+        repairWorldMap();
+    }
+    else if ( !_changedTiles.empty() || !isNodeSettled( targetIndex ) ) {
+        // The path to this tile was not found during the previous goal-directed search or it could have been changed since then
+        processWorldMap( targetIndex );
+    }
 }
 
 std::list<Route::Step> PlayerWorldPathfinder::buildPath( const int targetIndex ) const
@@ -333,11 +580,11 @@ std::list<Route::Step> PlayerWorldPathfinder::buildPath( const int targetIndex )
 }
 
 // Follows regular (for user's interface) passability rules
-void PlayerWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplore, int currentNodeIdx )
+void PlayerWorldPathfinder::processCurrentNode( NodeQueue & nodesToExplore, int currentNodeIdx )
 {
     const bool isFirstNode = currentNodeIdx == _pathStart;
 
-    if ( !isFirstNode && isTileBlocked( currentNodeIdx, world.GetTiles( _pathStart ).isWater() ) ) {
+    if ( !isFirstNode && isTileBlocked( currentNodeIdx, world.isWaterTile( _pathStart ) ) ) {
         return;
     }
 
@@ -356,10 +603,14 @@ void PlayerWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplor
 
                 WorldNode & monsterNode = _cache[monsterIndex];
 
-                if ( monsterNode._from == -1 || monsterNode._cost > moveCost ) {
+                if ( isBetterPath( monsterIndex, moveCost ) ) {
                     monsterNode._from = currentNodeIdx;
                     monsterNode._cost = moveCost;
                     monsterNode._remainingMovePoints = remainingMovePoints;
+                    _settledNodes[monsterIndex] = 0;
+
+                    // The monster's tile is never processed further, but it should be settled to finish a goal-directed search
+                    addNodeToExplore( nodesToExplore, monsterIndex );
                 }
             }
         }
@@ -369,6 +620,16 @@ void PlayerWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplor
     }
 }
 
+uint32_t PlayerWorldPathfinder::getCostEstimate( int nodeIdx, int targetIndex ) const
+{
+    const int32_t width = world.w();
+
+    const int32_t dx = std::abs( nodeIdx % width - targetIndex % width );
+    const int32_t dy = std::abs( nodeIdx / width - targetIndex / width );
+
+    return static_cast<uint32_t>( std::max( dx, dy ) ) * Maps::Ground::roadPenalty;
+}
+
 void AIWorldPathfinder::reset()
 {
     WorldPathfinder::checkWorldSize();
@@ -383,45 +644,48 @@ void AIWorldPathfinder::reset()
 
         _armyStrength = -1;
     }
+
+    _changedTiles.clear();
 }
 
 void AIWorldPathfinder::reEvaluateIfNeeded( const Heroes & hero )
 {
-    auto currentSettings = std::forward_as_tuple( _pathStart, _pathfindingSkill, _currentColor, _remainingMovePoints, _maxMovePoints, _armyStrength );
-    const auto newSettings = std::make_tuple( hero.GetIndex(), static_cast<uint8_t>( hero.GetLevelSkill( Skill::Secondary::PATHFINDING ) ), hero.GetColor(),
-                                              hero.GetMovePoints(), hero.GetMaxMovePoints(), hero.GetArmy().GetStrength() );
-
-    if ( currentSettings != newSettings ) {
-        currentSettings = newSettings;
-
-        processWorldMap();
-    }
+    reEvaluateIfNeeded( hero.GetIndex(), hero.GetColor(), hero.GetArmy().GetStrength(), static_cast<uint8_t>( hero.GetLevelSkill( Skill::Secondary::PATHFINDING ) ),
+                        hero.GetMovePoints(), hero.GetMaxMovePoints() );
 }
 
 void AIWorldPathfinder::reEvaluateIfNeeded( const int start, const int color, const double armyStrength, const uint8_t skill )
+{
+    reEvaluateIfNeeded( start, color, armyStrength, skill, 0U, 0U );
+}
+
+void AIWorldPathfinder::reEvaluateIfNeeded( const int start, const int color, const double armyStrength, const uint8_t skill, const uint32_t movePoints,
+                                            const uint32_t maxMovePoints )
 {
     auto currentSettings = std::forward_as_tuple( _pathStart, _pathfindingSkill, _currentColor, _remainingMovePoints, _maxMovePoints, _armyStrength );
-    const auto newSettings = std::make_tuple( start, skill, color, 0U, 0U, armyStrength );
+    const auto newSettings = std::make_tuple( start, skill, color, movePoints, maxMovePoints, armyStrength );
 
-    if ( currentSettings != newSettings ) {
+    // The previous search could process only a part of the map
+    if ( currentSettings != newSettings || !_isWholeMapProcessed ) {
         currentSettings = newSettings;
 
         processWorldMap();
     }
+    else {
+        repairWorldMap();
+    }
 }
 
 // Overwrites base version in WorldPathfinder, using custom node passability rules
-void AIWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplore, int currentNodeIdx )
+void AIWorldPathfinder::processCurrentNode( NodeQueue & nodesToExplore, int currentNodeIdx )
 {
     const bool isFirstNode = currentNodeIdx == _pathStart;
     WorldNode & currentNode = _cache[currentNodeIdx];
 
     // find out if current node is protected by a strong army
     auto protectionCheck = [this]( const int index ) {
-        const Maps::Tiles & tile = world.GetTiles( index );
-        if ( MP2::isProtectedObject( tile.GetObject() ) ) {
-            _temporaryArmy.setFromTile( tile );
-            return _temporaryArmy.GetStrength() * _advantage > _armyStrength;
+        if ( MP2::isProtectedObject( world.getTileObjectType( index ) ) ) {
+            return world.getTileArmyStrength( index ) * _advantage > _armyStrength;
         }
         return false;
     };
@@ -472,13 +736,14 @@ void AIWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplore, i
         WorldNode & teleportNode = _cache[teleportIdx];
 
         // check if move is actually faster through teleport
-        if ( teleportNode._from == -1 || teleportNode._cost > currentNode._cost ) {
+        if ( isBetterPath( teleportIdx, currentNode._cost ) ) {
             teleportNode._from = currentNodeIdx;
             teleportNode._cost = currentNode._cost;
-            teleportNode._objectID = world.GetTiles( teleportIdx ).GetObject();
+            teleportNode._objectID = world.getTileObjectType( teleportIdx );
             teleportNode._remainingMovePoints = currentNode._remainingMovePoints;
+            _settledNodes[teleportIdx] = 0;
 
-            nodesToExplore.push_back( teleportIdx );
+            addNodeToExplore( nodesToExplore, teleportIdx );
         }
     }
 }
@@ -495,11 +760,11 @@ uint32_t AIWorldPathfinder::getMovementPenalty( int src, int dst, int direction
         // No dead ends allowed
         assert( src == _pathStart || node._from != -1 );
 
-        const Maps::Tiles & srcTile = world.GetTiles( src );
-        const Maps::Tiles & dstTile = world.GetTiles( dst );
+        const bool isSrcTileWater = world.isWaterTile( src );
+        const MP2::MapObjectType dstObjectType = world.getTileObjectType( dst );
 
         // When the hero gets into a boat or disembarks, he spends all remaining movement points.
-        if ( ( !srcTile.isWater() && dstTile.GetObject() == MP2::OBJ_BOAT ) || ( srcTile.isWater() && dstTile.GetObject() == MP2::OBJ_COAST ) ) {
+        if ( ( !isSrcTileWater && dstObjectType == MP2::OBJ_BOAT ) || ( isSrcTileWater && dstObjectType == MP2::OBJ_COAST ) ) {
             // If the hero is not able to make this movement this turn, then he will have to spend
             // all the movement points next turn.
             if ( defaultPenalty > node._remainingMovePoints ) {
@@ -563,7 +828,7 @@ int AIWorldPathfinder::getFogDiscoveryTile( const Heroes & hero )
 
             tilesVisited[newIndex] = true;
 
-            if ( !MP2::isSafeForFogDiscoveryObject( world.GetTiles( newIndex ).GetObject( true ) ) ) {
+            if ( !MP2::isSafeForFogDiscoveryObject( world.getTileObjectType( newIndex ) ) ) {
                 continue;
             }
 
@@ -623,7 +888,7 @@ int AIWorldPathfinder::getNearestTileToMove( const Heroes & hero )
         }
 
         // Don't go onto action objects as they might be castles or dwellings with guards.
-        if ( MP2::isActionObject( world.GetTiles( newIndex ).GetObject( true ) ) ) {
+        if ( MP2::isActionObject( world.getTileObjectType( newIndex ) ) ) {
             continue;
         }
 
@@ -811,7 +1076,7 @@ std::list<Route::Step> AIWorldPathfinder::buildPath( const int targetIndex, cons
         return path;
     }
 
-    const bool fromWater = world.GetTiles( _pathStart ).isWater();
+    const bool fromWater = world.isWaterTile( _pathStart );
 
 #ifndef NDEBUG
     std::set<int> uniqPathIndexes;
@@ -856,6 +1121,36 @@ uint32_t AIWorldPathfinder::getDistance( int start, int targetIndex, int color,
     return _cache[targetIndex]._cost;
 }
 
+std::vector<uint32_t> AIWorldPathfinder::getDistances( int start, const std::vector<int> & targets, int color, double armyStrength, uint32_t distanceLimit,
+                                                       uint8_t skill )
+{
+    auto currentSettings = std::forward_as_tuple( _pathStart, _pathfindingSkill, _currentColor, _remainingMovePoints, _maxMovePoints, _armyStrength );
+    const auto newSettings = std::make_tuple( start, skill, color, 0U, 0U, armyStrength );
+
+    if ( currentSettings != newSettings ) {
+        currentSettings = newSettings;
+
+        processWorldMap( targets, distanceLimit );
+    }
+    else if ( _isWholeMapProcessed ) {
+        repairWorldMap();
+    }
+    else if ( !_changedTiles.empty()
+              || !std::all_of( targets.begin(), targets.end(), [this]( const int targetIndex ) { return isNodeSettled( targetIndex ); } ) ) {
+        processWorldMap( targets, distanceLimit );
+    }
+
+    std::vector<uint32_t> distances;
+    distances.reserve( targets.size() );
+
+    for ( const int targetIndex : targets ) {
+        // The search may stop before reaching the target if it is too far away
+        distances.push_back( isNodeSettled( targetIndex ) ? _cache[targetIndex]._cost : 0 );
+    }
+
+    return distances;
+}
+
 void AIWorldPathfinder::setArmyStrengthMultiplier( const double multiplier )
 {
     if ( multiplier > 0 && std::fabs( _advantage - multiplier ) > 0.001 ) {
@@ -20,6 +20,10 @@
 
 #pragma once
 
+#include <functional>
+#include <queue>
+#include <utility>
+
 #include "army.h"
 #include "color.h"
 #include "mp2.h"
@@ -68,12 +72,56 @@ public:
 
     static uint32_t calculatePathPenalty( const std::list<Route::Step> & path );
 
+    // Informs the pathfinder that the contents of the given tile have been changed. Instead of processing the whole map again, the next
+    // evaluation with the same settings re-evaluates only the paths which could be affected by the changed tiles.
+    void invalidateTile( const int tileIndex );
+
 protected:
-    void processWorldMap();
-    void checkAdjacentNodes( std::vector<int> & nodesToExplore, int currentNodeIdx );
+    // Min-priority queue of the nodes to explore. Each entry is a pair of the node's priority (cost of the path to this node plus
+    // the estimated cost of the rest of the path in case of goal-directed search) and the node's index. A node is pushed every
+    // time its cost is improved, so outdated entries are allowed and are skipped when popped.
+    using NodeQueue = std::priority_queue<std::pair<uint32_t, int>, std::vector<std::pair<uint32_t, int>>, std::greater<std::pair<uint32_t, int>>>;
+
+    // Resets the cache and puts the starting node to the queue
+    void initializeSearch( NodeQueue & nodesToExplore, const int targetIndex );
+
+    // Performs a label-setting search from _pathStart, every reachable node is processed exactly once. If targetIndex is specified,
+    // then the search is goal-directed (A*) and stops as soon as the cost of the path to the target node is known.
+    void processWorldMap( const int targetIndex = -1 );
+
+    // Performs a label-setting search from _pathStart which stops as soon as the costs of the paths to all the given target nodes are known
+    // or the costs of the paths to the rest of the nodes exceed the cost limit. The cost limit equal to 0 means that there is no limit.
+    void processWorldMap( const std::vector<int> & targets, const uint32_t costLimit );
+
+    // Brings the results of the previous search of the whole map up to date with the tiles changed since then. Only the nodes whose paths
+    // pass through the changed tiles or their neighbours are evaluated again, the rest of the nodes can only get a cheaper path.
+    void repairWorldMap();
+
+    void checkAdjacentNodes( NodeQueue & nodesToExplore, int currentNodeIdx );
+    void addNodeToExplore( NodeQueue & nodesToExplore, int nodeIdx ) const;
+
+    // Returns true if the path to the node with the given cost is better than the current one
+    bool isBetterPath( const int nodeIdx, const uint32_t cost ) const;
+
+    // Returns the index of the next node whose cost is final or -1 if there are no more nodes to explore
+    int settleNextNode( NodeQueue & nodesToExplore );
+
+    // Returns true if the cost of the path to this node is final according to the results of the last search
+    bool isNodeSettled( const int nodeIdx ) const
+    {
+        return _isWholeMapProcessed || _settledNodes[nodeIdx];
+    }
 
     // This method defines pathfinding rules. This has to be implemented by the derived class.
-    virtual void processCurrentNode( std::vector<int> & nodesToExplore, int currentNodeIdx ) = 0;
+    virtual void processCurrentNode( NodeQueue & nodesToExplore, int currentNodeIdx ) = 0;
+
+    // Returns the lower bound of the cost of the path from the given node to the target node of a goal-directed search. The default
+    // implementation returns 0, which turns the goal-directed search into a regular Dijkstra search with early exit. Derived classes
+    // may override this method as long as the returned estimate never exceeds the real cost and is consistent between adjacent nodes.
+    virtual uint32_t getCostEstimate( int /* nodeIdx */, int /* targetIndex */ ) const
+    {
+        return 0;
+    }
 
     // Calculates the movement penalty when moving from the src tile to the adjacent dst tile in the specified direction.
     // If the "last move" logic should be taken into account (when performing pathfinding for a real hero on the map),
@@ -89,6 +137,16 @@ protected:
     uint32_t _remainingMovePoints = 0;
     uint32_t _maxMovePoints = 0;
     std::vector<int> _mapOffset;
+
+    // Nodes whose cost is final, valid only for the current search settings
+    std::vector<uint8_t> _settledNodes;
+    // Target node of the current goal-directed search or -1 if the search is not goal-directed
+    int _searchTarget = -1;
+    bool _isWholeMapProcessed = false;
+    bool _isRepairing = false;
+
+    // Tiles changed since the last search
+    std::vector<int> _changedTiles;
 };
 
 class PlayerWorldPathfinder : public WorldPathfinder
@@ -102,10 +160,17 @@ public:
     void reset() override;
 
     void reEvaluateIfNeeded( const Heroes & hero );
+
+    // Re-evaluates only the part of the map required to get the path to the given tile, uses goal-directed search
+    void reEvaluateIfNeeded( const Heroes & hero, const int targetIndex );
+
     std::list<Route::Step> buildPath( const int targetIndex ) const;
 
 private:
-    void processCurrentNode( std::vector<int> & nodesToExplore, int currentNodeIdx ) override;
+    void processCurrentNode( NodeQueue & nodesToExplore, int currentNodeIdx ) override;
+
+    // Every step costs at least as much as a step along the road, so the Chebyshev distance to the target is a valid estimate
+    uint32_t getCostEstimate( int nodeIdx, int targetIndex ) const override;
 };
 
 class AIWorldPathfinder : public WorldPathfinder
@@ -123,6 +188,12 @@ public:
 
     void reEvaluateIfNeeded( const Heroes & hero );
     void reEvaluateIfNeeded( const int start, const int color, const double armyStrength, const uint8_t skill );
+
+    // Performs the same evaluation as for a hero with the given parameters, but doesn't access the hero itself. The map is accessed
+    // only for reading, so several pathfinders can be evaluated simultaneously as long as the world is not modified.
+    void reEvaluateIfNeeded( const int start, const int color, const double armyStrength, const uint8_t skill, const uint32_t movePoints,
+                             const uint32_t maxMovePoints );
+
     int getFogDiscoveryTile( const Heroes & hero );
 
     // Used for cases when heroes are stuck because one hero might be blocking the way and we have to move him.
@@ -137,6 +208,12 @@ public:
     // Used for non-hero armies, like castles or monsters
     uint32_t getDistance( int start, int targetIndex, int color, double armyStrength, uint8_t skill = Skill::Level::EXPERT );
 
+    // Calculates distances from the start tile to all the target tiles in a single pass. Exploration of the map stops as soon as all the
+    // targets are reached or the distance exceeds the given limit (0 means no limit). The distance is 0 for unreachable targets as well
+    // as for targets which are further away than the limit.
+    std::vector<uint32_t> getDistances( int start, const std::vector<int> & targets, int color, double armyStrength, uint32_t distanceLimit = 0,
+                                        uint8_t skill = Skill::Level::EXPERT );
+
     // Override builds path to the nearest valid object
     std::list<Route::Step> buildPath( const int targetIndex, const bool isPlanningMode = false ) const;
 
@@ -151,7 +228,7 @@ public:
     void setArmyStrengthMultiplier( const double multiplier );
 
 private:
-    void processCurrentNode( std::vector<int> & nodesToExplore, int currentNodeIdx ) override;
+    void processCurrentNode( NodeQueue & nodesToExplore, int currentNodeIdx ) override;
 
     // Adds special logic for AI-controlled heroes to encourage them to overcome water obstacles using boats.
     // If this logic should be taken into account (when performing pathfinding for a real hero on the map),
@@ -161,5 +238,4 @@ private:
 
     double _armyStrength = -1;
     double _advantage = 1.0;
-    Army _temporaryArmy; // for internal calculations
 };
@@ -18,6 +18,12 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+
+#include "ground.h"
 #include "world.h"
 
 namespace
@@ -66,6 +72,26 @@ namespace
         return ( index / originalWidth + 1 ) * width + ( index % originalWidth ) + 1;
     }
 
+    // Same as the movement penalty for a hero with the expert pathfinding skill, the lowest possible one
+    uint32_t GetStaticMovementPenalty( const int32_t from, const int32_t to, const int direction )
+    {
+        uint32_t penalty = world.isRoadTile( from ) && world.isRoadTile( to ) ? Maps::Ground::roadPenalty
+                                                                              : Maps::Ground::GetPenalty( world.getTileGround( from ), Skill::Level::EXPERT );
+
+        if ( Direction::isDiagonal( direction ) ) {
+            penalty = penalty * 3 / 2;
+        }
+
+        return penalty;
+    }
+
+    // Objects which disappear from the map after being visited or defeated, the tiles covered by their sprites become passable then
+    bool isRemovableObject( const MP2::MapObjectType objectType )
+    {
+        return MP2::isPickupObject( objectType ) || objectType == MP2::OBJ_MONSTER || objectType == MP2::OBJ_HEROES || objectType == MP2::OBJ_BOAT
+               || objectType == MP2::OBJ_BARRIER || objectType == MP2::OBJ_JAIL;
+    }
+
     bool AppendIfFarEnough( std::vector<int> & dataSet, int value, uint32_t distance )
     {
         for ( const int current : dataSet ) {
@@ -149,6 +175,240 @@ size_t World::getRegionCount() const
     return _regions.size();
 }
 
+uint32_t World::getRegionDistance( const int32_t fromIndex, const int32_t toIndex ) const
+{
+    const uint32_t fromRegion = getTileRegion( fromIndex );
+    const uint32_t toRegion = getTileRegion( toIndex );
+
+    if ( fromRegion < REGION_NODE_FOUND || toRegion < REGION_NODE_FOUND || _regionDistances.size() != _regions.size() * _regions.size() ) {
+        return 0;
+    }
+
+    return _regionDistances[fromRegion * _regions.size() + toRegion];
+}
+
+void World::computeRegionDistances()
+{
+    struct RegionExit
+    {
+        int32_t tileIndex;
+        uint32_t regionID;
+        uint32_t cost;
+    };
+
+    using CostQueue = std::priority_queue<std::pair<uint32_t, size_t>, std::vector<std::pair<uint32_t, size_t>>, std::greater<std::pair<uint32_t, size_t>>>;
+
+    const size_t regionCount = _regions.size();
+    const uint32_t noPath = std::numeric_limits<uint32_t>::max();
+    const Directions & directions = Direction::All();
+
+    const int32_t tileCount = static_cast<int32_t>( vec_tiles.size() );
+
+    // The distances must not be longer than the real paths at any moment of the game. Removable objects (like monsters or the jail)
+    // and their sprites are ignored, the tiles covered by them are considered passable and belonging to the region of the object.
+    std::vector<bool> clearedTiles( vec_tiles.size(), false );
+    std::vector<uint32_t> tileRegions( _tileRegion );
+
+    for ( int32_t tileIndex = 0; tileIndex < tileCount; ++tileIndex ) {
+        const uint32_t regionID = _tileRegion[tileIndex];
+        if ( regionID < REGION_NODE_FOUND || !isRemovableObject( _tileObjectType[tileIndex] ) ) {
+            continue;
+        }
+
+        // The same tiles are cleared when the object is removed, see Maps::Tiles::RemoveObjectSprite()
+        std::vector<int32_t> spriteTiles{ tileIndex };
+
+        if ( Maps::isValidDirection( tileIndex, Direction::LEFT ) ) {
+            const int32_t leftIndex = Maps::GetDirectionIndex( tileIndex, Direction::LEFT );
+            spriteTiles.push_back( leftIndex );
+
+            if ( Maps::isValidDirection( leftIndex, Direction::LEFT ) ) {
+                spriteTiles.push_back( Maps::GetDirectionIndex( leftIndex, Direction::LEFT ) );
+            }
+        }
+
+        if ( Maps::isValidDirection( tileIndex, Direction::TOP ) ) {
+            const int32_t topIndex = Maps::GetDirectionIndex( tileIndex, Direction::TOP );
+            spriteTiles.push_back( topIndex );
+
+            if ( Maps::isValidDirection( topIndex, Direction::LEFT ) ) {
+                spriteTiles.push_back( Maps::GetDirectionIndex( topIndex, Direction::LEFT ) );
+            }
+        }
+
+        for ( const int32_t spriteIndex : spriteTiles ) {
+            clearedTiles[spriteIndex] = true;
+
+            if ( tileRegions[spriteIndex] < REGION_NODE_FOUND ) {
+                tileRegions[spriteIndex] = regionID;
+            }
+        }
+    }
+
+    // Regions are connected through the adjacent tiles, teleports and whirlpools. Unlike the region growing, water and ground tiles are also
+    // connected, because the armies can use boats.
+    std::vector<std::vector<RegionExit>> regionExits( regionCount );
+    // Tiles of the region through which it is entered from every neighbour
+    std::vector<std::map<uint32_t, std::vector<int32_t>>> regionEntrances( regionCount );
+
+    auto forEachMove = [this, &directions, &clearedTiles]( const int32_t tileIndex, const std::function<void( int32_t, uint32_t )> & action ) {
+        const uint16_t passability = _tilePassability[tileIndex];
+
+        for ( const int direction : directions ) {
+            if ( !Maps::isValidDirection( tileIndex, direction ) ) {
+                continue;
+            }
+
+            const int32_t newIndex = Maps::GetDirectionIndex( tileIndex, direction );
+
+            // Passability of the neighbours of removed objects can change as well
+            const bool isCleared = clearedTiles[tileIndex] || clearedTiles[newIndex];
+
+            if ( isCleared || ( ( passability & direction ) && ( _tilePassability[newIndex] & Direction::Reflect( direction ) ) ) ) {
+                action( newIndex, GetStaticMovementPenalty( tileIndex, newIndex, direction ) );
+            }
+        }
+
+        // Teleports don't cost anything
+        for ( const int32_t exitIndex : GetTeleportEndPoints( tileIndex ) ) {
+            action( exitIndex, 0 );
+        }
+
+        for ( const int32_t exitIndex : GetWhirlpoolEndPoints( tileIndex ) ) {
+            action( exitIndex, 0 );
+        }
+    };
+
+    for ( int32_t tileIndex = 0; tileIndex < tileCount; ++tileIndex ) {
+        const uint32_t regionID = tileRegions[tileIndex];
+        if ( regionID < REGION_NODE_FOUND ) {
+            continue;
+        }
+
+        forEachMove( tileIndex, [&tileRegions, &regionExits, &regionEntrances, regionID, tileIndex]( const int32_t exitIndex, const uint32_t cost ) {
+            const uint32_t exitRegionID = tileRegions[exitIndex];
+
+            if ( exitRegionID >= REGION_NODE_FOUND && exitRegionID != regionID ) {
+                regionExits[regionID].push_back( { tileIndex, exitRegionID, cost } );
+                regionEntrances[exitRegionID][regionID].push_back( exitIndex );
+            }
+        } );
+    }
+
+    // Every node of the abstract graph is a region entered from one of its neighbours
+    std::vector<std::map<uint32_t, size_t>> nodeIDs( regionCount );
+    std::vector<uint32_t> nodeRegions;
+
+    for ( size_t regionID = REGION_NODE_FOUND; regionID < regionCount; ++regionID ) {
+        for ( const auto & entrance : regionEntrances[regionID] ) {
+            nodeIDs[regionID][entrance.first] = nodeRegions.size();
+            nodeRegions.push_back( static_cast<uint32_t>( regionID ) );
+        }
+    }
+
+    // Edges of the abstract graph: the cost to cross the region from the entrance to the exit, calculated inside the region only
+    std::vector<std::map<size_t, uint32_t>> nodeEdges( nodeRegions.size() );
+    std::vector<uint32_t> tileCosts( vec_tiles.size(), noPath );
+    std::vector<int32_t> exploredTiles;
+
+    for ( size_t regionID = REGION_NODE_FOUND; regionID < regionCount; ++regionID ) {
+        for ( const auto & entrance : regionEntrances[regionID] ) {
+            CostQueue tilesToExplore;
+
+            for ( const int32_t tileIndex : entrance.second ) {
+                tileCosts[tileIndex] = 0;
+                tilesToExplore.emplace( 0, tileIndex );
+                exploredTiles.push_back( tileIndex );
+            }
+
+            while ( !tilesToExplore.empty() ) {
+                const uint32_t cost = tilesToExplore.top().first;
+                const int32_t tileIndex = static_cast<int32_t>( tilesToExplore.top().second );
+                tilesToExplore.pop();
+
+                if ( cost > tileCosts[tileIndex] ) {
+                    continue;
+                }
+
+                forEachMove( tileIndex, [&tileRegions, &tileCosts, &tilesToExplore, &exploredTiles, regionID, cost]( const int32_t newIndex, const uint32_t penalty ) {
+                    if ( tileRegions[newIndex] == regionID && cost + penalty < tileCosts[newIndex] ) {
+                        tileCosts[newIndex] = cost + penalty;
+                        tilesToExplore.emplace( cost + penalty, newIndex );
+                        exploredTiles.push_back( newIndex );
+                    }
+                } );
+            }
+
+            std::map<size_t, uint32_t> & edges = nodeEdges[nodeIDs[regionID][entrance.first]];
+
+            for ( const RegionExit & regionExit : regionExits[regionID] ) {
+                if ( tileCosts[regionExit.tileIndex] == noPath ) {
+                    continue;
+                }
+
+                const size_t nextNodeID = nodeIDs[regionExit.regionID][static_cast<uint32_t>( regionID )];
+                const uint32_t cost = tileCosts[regionExit.tileIndex] + regionExit.cost;
+
+                auto edge = edges.find( nextNodeID );
+                if ( edge == edges.end() ) {
+                    edges.emplace( nextNodeID, cost );
+                }
+                else if ( edge->second > cost ) {
+                    edge->second = cost;
+                }
+            }
+
+            for ( const int32_t tileIndex : exploredTiles ) {
+                tileCosts[tileIndex] = noPath;
+            }
+
+            exploredTiles.clear();
+        }
+    }
+
+    // The path may start anywhere in the source region, so the regions are compared without taking the source tile into account
+    _regionDistances.assign( regionCount * regionCount, noPath );
+
+    std::vector<uint32_t> nodeCosts;
+
+    for ( size_t regionID = REGION_NODE_FOUND; regionID < regionCount; ++regionID ) {
+        uint32_t * distances = &_regionDistances[regionID * regionCount];
+        distances[regionID] = 0;
+
+        nodeCosts.assign( nodeRegions.size(), noPath );
+        CostQueue nodesToExplore;
+
+        for ( const RegionExit & regionExit : regionExits[regionID] ) {
+            const size_t nodeID = nodeIDs[regionExit.regionID][static_cast<uint32_t>( regionID )];
+
+            if ( regionExit.cost < nodeCosts[nodeID] ) {
+                nodeCosts[nodeID] = regionExit.cost;
+                nodesToExplore.emplace( regionExit.cost, nodeID );
+            }
+        }
+
+        while ( !nodesToExplore.empty() ) {
+            const uint32_t cost = nodesToExplore.top().first;
+            const size_t nodeID = nodesToExplore.top().second;
+            nodesToExplore.pop();
+
+            if ( cost > nodeCosts[nodeID] ) {
+                continue;
+            }
+
+            uint32_t & distance = distances[nodeRegions[nodeID]];
+            distance = std::min( distance, cost );
+
+            for ( const auto & edge : nodeEdges[nodeID] ) {
+                if ( cost + edge.second < nodeCosts[edge.first] ) {
+                    nodeCosts[edge.first] = cost + edge.second;
+                    nodesToExplore.emplace( cost + edge.second, edge.first );
+                }
+            }
+        }
+    }
+}
+
 const MapRegion & World::getRegion( size_t id ) const
 {
     if ( id < _regions.size() )
@@ -191,15 +451,14 @@ void World::ComputeStaticAnalysis()
         const int rowIndex = y * width;
         for ( int x = 0; x < width; ++x ) {
             const int index = rowIndex + x;
-            const Maps::Tiles & tile = vec_tiles[index];
             // If tile is blocked (mountain, trees, etc) then it's applied to both
-            if ( tile.GetPassable() == 0 ) {
+            if ( _tilePassability[index] == 0 ) {
                 ++obstacles[0][x].second;
                 ++obstacles[1][y].second;
                 ++obstacles[2][x].second;
                 ++obstacles[3][y].second;
             }
-            else if ( tile.isWater() ) {
+            else if ( isWaterTile( index ) ) {
                 // if it's water then ground tiles consider it an obstacle
                 ++obstacles[2][x].second;
                 ++obstacles[3][y].second;
@@ -257,16 +516,15 @@ void World::ComputeStaticAnalysis()
                 int centerIndex = -1;
 
                 const int tileIndex = rowIndex + colID;
-                const Maps::Tiles & tile = vec_tiles[tileIndex];
-                if ( tile.GetPassable() && tile.isWater() ) {
+                const bool isWater = isWaterTile( tileIndex );
+                if ( _tilePassability[tileIndex] && isWater ) {
                     centerIndex = tileIndex;
                 }
                 else {
                     for ( uint8_t direction = 0; direction < 8; ++direction ) {
                         const int newIndex = tileIndex + directionOffsets[direction];
                         if ( newIndex >= 0 && static_cast<size_t>( newIndex ) < totalMapTiles ) {
-                            const Maps::Tiles & newTile = vec_tiles[newIndex];
-                            if ( newTile.GetPassable() != 0 && tile.isWater() == ( waterOrGround != 0 ) ) {
+                            if ( _tilePassability[newIndex] != 0 && isWater == ( waterOrGround != 0 ) ) {
                                 centerIndex = newIndex;
                                 break;
                             }
@@ -288,14 +546,13 @@ void World::ComputeStaticAnalysis()
         const int rowIndex = y * width;
         for ( int x = 0; x < width; ++x ) {
             const int index = rowIndex + x;
-            const Maps::Tiles & tile = vec_tiles[index];
             MapRegionNode & node = data[ConvertExtendedIndex( index, extendedWidth )];
 
             node.index = index;
-            node.passable = tile.GetPassable();
-            node.isWater = tile.isWater();
+            node.passable = _tilePassability[index];
+            node.isWater = isWaterTile( index );
 
-            const MP2::MapObjectType objectType = tile.GetObject();
+            const MP2::MapObjectType objectType = _tileObjectType[index];
             node.mapObject = MP2::isActionObject( objectType, node.isWater ) ? objectType : 0;
             if ( node.passable != 0 ) {
                 node.type = REGION_NODE_OPEN;
@@ -312,7 +569,7 @@ void World::ComputeStaticAnalysis()
 
     for ( const int tileIndex : regionCenters ) {
         const int regionID = static_cast<int>( _regions.size() ); // Safe to do as we can't have so many regions
-        _regions.emplace_back( regionID, tileIndex, vec_tiles[tileIndex].isWater(), averageRegionSize );
+        _regions.emplace_back( regionID, tileIndex, isWaterTile( tileIndex ), averageRegionSize );
         data[ConvertExtendedIndex( tileIndex, extendedWidth )].type = regionID;
     }
 
@@ -352,7 +609,7 @@ void World::ComputeStaticAnalysis()
 
             for ( const int exitIndex : exits ) {
                 // neighbours is a set that will force the uniqness
-                reg._neighbours.insert( vec_tiles[exitIndex].GetRegion() );
+                reg._neighbours.insert( _tileRegion[exitIndex] );
             }
         }
 
@@ -361,4 +618,7 @@ void World::ComputeStaticAnalysis()
             _regions[adjacent]._neighbours.insert( reg._id );
         }
     }
+
+    // Step 10. Calculate the distances between the regions
+    computeRegionDistances();
 }
@@ -0,0 +1,286 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2022                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "agg.h"
+#include "army.h"
+#include "battle.h"
+#include "battle_arena.h"
+#include "battle_army.h"
+#include "bin_info.h"
+#include "color.h"
+#include "logging.h"
+#include "monster.h"
+#include "players.h"
+#include "rand.h"
+#include "settings.h"
+#include "system.h"
+#include "tools.h"
+#include "world.h"
+
+namespace
+{
+    const int attackerColor = Color::BLUE;
+    const int defenderColor = Color::RED;
+
+    // Army specification is a comma separated list of up to 5 stacks in the "<monster name>:<count>" format, e.g. "Archer:20,Swordsman:10"
+    using ArmySpec = std::vector<std::pair<Monster, uint32_t>>;
+
+    struct SideStats
+    {
+        std::atomic<uint32_t> wins{ 0 };
+        std::atomic<uint64_t> deadCount{ 0 };
+        std::atomic<uint64_t> deadHitPoints{ 0 };
+    };
+
+    int PrintHelp( const char * basename )
+    {
+        std::cout << "Usage: " << basename << " -a <attacker army> -d <defender army> [OPTIONS]" << std::endl
+                  << "Runs AI vs AI battles between two armies without user interface and reports the results." << std::endl
+                  << "Army is a comma separated list of stacks in the <monster name>:<count> format, e.g. \"Archer:20,Swordsman:10\"." << std::endl
+                  << "  -n <count>\tnumber of battles to run (default: 1000)" << std::endl
+                  << "  -s <seed>\tseed of the first battle, every next battle uses the next seed (default: 0)" << std::endl
+                  << "  -j <count>\tnumber of worker threads (default: number of CPU cores)" << std::endl
+                  << "  -t <count>\tmaximum number of turns in a battle, longer battles are counted as draws (default: 100)" << std::endl
+                  << "  -h\t\tprint this help message and exit" << std::endl;
+
+        return EXIT_SUCCESS;
+    }
+
+    Monster FindMonster( const std::string & name )
+    {
+        const std::string lowerName = StringLower( name );
+
+        for ( int id = Monster::PEASANT; id <= Monster::WATER_ELEMENT; ++id ) {
+            const Monster monster( id );
+
+            if ( StringLower( monster.GetName() ) == lowerName || StringLower( monster.GetMultiName() ) == lowerName ) {
+                return monster;
+            }
+        }
+
+        return Monster( Monster::UNKNOWN );
+    }
+
+    bool ParseArmySpec( const std::string & spec, ArmySpec & army )
+    {
+        army.clear();
+
+        size_t pos = 0;
+        while ( pos < spec.size() ) {
+            size_t end = spec.find( ',', pos );
+            if ( end == std::string::npos ) {
+                end = spec.size();
+            }
+
+            const std::string stack = spec.substr( pos, end - pos );
+            pos = end + 1;
+
+            const size_t separator = stack.rfind( ':' );
+            if ( separator == std::string::npos ) {
+                std::cout << "Stack '" << stack << "' has no monster count" << std::endl;
+                return false;
+            }
+
+            const Monster monster = FindMonster( stack.substr( 0, separator ) );
+            if ( !monster.isValid() ) {
+                std::cout << "Unknown monster '" << stack.substr( 0, separator ) << "'" << std::endl;
+                return false;
+            }
+
+            const int count = GetInt( stack.substr( separator + 1 ) );
+            if ( count <= 0 ) {
+                std::cout << "Invalid monster count in stack '" << stack << "'" << std::endl;
+                return false;
+            }
+
+            army.emplace_back( monster, static_cast<uint32_t>( count ) );
+        }
+
+        if ( army.empty() || army.size() > ARMYMAXTROOPS ) {
+            std::cout << "Army must contain from 1 to " << ARMYMAXTROOPS << " stacks" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    void FillArmy( Army & army, const ArmySpec & spec, const int color )
+    {
+        for ( const std::pair<Monster, uint32_t> & stack : spec ) {
+            army.JoinTroop( stack.first, stack.second, true );
+        }
+
+        army.SetColor( color );
+    }
+
+    void PrintSideStats( const char * name, const SideStats & stats, const uint32_t battles )
+    {
+        std::cout << name << ": wins " << stats.wins << " (" << std::fixed << std::setprecision( 1 ) << 100.0 * stats.wins / battles << "%), average losses "
+                  << std::setprecision( 2 ) << static_cast<double>( stats.deadCount ) / battles << " units / "
+                  << static_cast<double>( stats.deadHitPoints ) / battles << " HP" << std::endl;
+    }
+}
+
+int main( int argc, char ** argv )
+{
+    Logging::InitLog();
+
+    Settings & conf = Settings::Get();
+    conf.SetProgramPath( argv[0] );
+
+    ArmySpec attackerSpec;
+    ArmySpec defenderSpec;
+    uint32_t battleCount = 1000;
+    uint32_t firstSeed = 0;
+    uint32_t threadCount = std::max( 1u, std::thread::hardware_concurrency() );
+    uint32_t turnLimit = 100;
+
+    {
+        int opt;
+        while ( ( opt = System::GetCommandOptions( argc, argv, "a:d:n:s:j:t:h" ) ) != -1 ) {
+            const char * argument = System::GetOptionsArgument();
+
+            switch ( opt ) {
+            case 'a':
+                if ( !argument || !ParseArmySpec( argument, attackerSpec ) )
+                    return EXIT_FAILURE;
+                break;
+            case 'd':
+                if ( !argument || !ParseArmySpec( argument, defenderSpec ) )
+                    return EXIT_FAILURE;
+                break;
+            case 'n':
+                battleCount = argument ? static_cast<uint32_t>( std::max( 1, GetInt( argument ) ) ) : battleCount;
+                break;
+            case 's':
+                firstSeed = argument ? static_cast<uint32_t>( std::strtoul( argument, nullptr, 10 ) ) : firstSeed;
+                break;
+            case 'j':
+                threadCount = argument ? static_cast<uint32_t>( std::max( 1, GetInt( argument ) ) ) : threadCount;
+                break;
+            case 't':
+                turnLimit = argument ? static_cast<uint32_t>( std::max( 1, GetInt( argument ) ) ) : turnLimit;
+                break;
+            case '?':
+            case 'h':
+            default:
+                return PrintHelp( argv[0] );
+            }
+        }
+    }
+
+    if ( attackerSpec.empty() || defenderSpec.empty() ) {
+        return PrintHelp( argv[0] );
+    }
+
+    try {
+        // Only the game data is required, no video or audio
+        const AGG::AGGInitializer aggInitializer;
+
+        // Monster animation data is used by battle units, load it before starting the worker threads so it is only read by them
+        Bin_Info::InitBinInfo();
+
+        // Both armies are controlled by AI
+        Players & players = conf.GetPlayers();
+        players.Init( attackerColor | defenderColor );
+        Players::SetPlayerControl( attackerColor, CONTROL_AI );
+        Players::SetPlayerControl( defenderColor, CONTROL_AI );
+
+        // Battlefield obstacles depend on the map seed and the battle tile, so the map must be the same for the same seed
+        Rand::CurrentThreadRandomDevice().seed( firstSeed );
+        world.NewMaps( 36, 36 );
+
+        SideStats attackerStats;
+        SideStats defenderStats;
+        std::atomic<uint32_t> draws{ 0 };
+        std::atomic<uint32_t> nextBattle{ 0 };
+
+        // Results of every battle depend only on its seed, not on the thread which runs it
+        auto runBattles = [&]() {
+            uint32_t battleId;
+            while ( ( battleId = nextBattle.fetch_add( 1 ) ) < battleCount ) {
+                Army attacker;
+                Army defender;
+                FillArmy( attacker, attackerSpec, attackerColor );
+                FillArmy( defender, defenderSpec, defenderColor );
+
+                const int32_t tileIndex = static_cast<int32_t>( battleId % world.getSize() );
+
+                Rand::DeterministicRandomGenerator randomGenerator( firstSeed + battleId );
+                Battle::Arena arena( attacker, defender, tileIndex, false, randomGenerator );
+
+                while ( arena.BattleValid() && arena.GetCurrentTurn() <= turnLimit ) {
+                    arena.Turns();
+                }
+
+                const Battle::Result & result = arena.GetResult();
+                if ( result.AttackerWins() ) {
+                    ++attackerStats.wins;
+                }
+                else if ( result.DefenderWins() ) {
+                    ++defenderStats.wins;
+                }
+                else {
+                    ++draws;
+                }
+
+                attackerStats.deadCount += arena.GetForce1().GetDeadCounts();
+                attackerStats.deadHitPoints += arena.GetForce1().GetDeadHitPoints();
+                defenderStats.deadCount += arena.GetForce2().GetDeadCounts();
+                defenderStats.deadHitPoints += arena.GetForce2().GetDeadHitPoints();
+            }
+        };
+
+        threadCount = std::min( threadCount, battleCount );
+
+        std::vector<std::thread> workers;
+        workers.reserve( threadCount - 1 );
+        for ( uint32_t i = 1; i < threadCount; ++i ) {
+            workers.emplace_back( runBattles );
+        }
+
+        runBattles();
+
+        for ( std::thread & worker : workers ) {
+            worker.join();
+        }
+
+        std::cout << "Battles: " << battleCount << ", seeds " << firstSeed << " - " << firstSeed + battleCount - 1 << ", threads: " << threadCount << std::endl;
+        PrintSideStats( "Attacker", attackerStats, battleCount );
+        PrintSideStats( "Defender", defenderStats, battleCount );
+        std::cout << "Draws: " << draws << std::endl;
+    }
+    catch ( const std::exception & ex ) {
+        std::cout << "Exception '" << ex.what() << "' occured during the simulation." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}